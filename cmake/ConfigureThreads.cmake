@@ -0,0 +1,6 @@
+set(THREADS_PREFER_PTHREAD_FLAG ON)
+find_package(Threads REQUIRED)
+
+if(NOT Threads_FOUND)
+    message(FATAL_ERROR "A thread library is required to build this project !")
+endif()
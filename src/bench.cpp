@@ -0,0 +1,504 @@
+// STD
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+
+// PROJECT
+#include "docopt/docopt.h"
+#include "mesh/conversion.hpp"
+#include "mesh/export.hpp"
+#include "mesh/flat.hpp"
+#include "mesh/import.hpp"
+#include "mesh/loader.hpp"
+#include "mesh/marking.hpp"
+#include "mesh/parallel.hpp"
+#include "mesh/profiling.hpp"
+#include "mesh/projection.hpp"
+#include "mesh/reader.hpp"
+
+// CGAL
+#include <CGAL/Polygon_mesh_processing/merge_border_vertices.h>
+
+// Renvoie la plus petite durée (en millisecondes) de 'repeat' exécutions de 'function'.
+// 'setup' est appelé avant chaque exécution et n'est pas mesuré.
+template <class Setup, class Function>
+double measure(size_t repeat, Setup&& setup, Function&& function)
+{
+    double best = std::numeric_limits<double>::max();
+
+    for(size_t i = 0; i < repeat; ++i)
+    {
+        setup();
+
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+
+        best = std::min(
+            best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    return best;
+}
+
+template <class Function>
+double measure(size_t repeat, Function&& function)
+{
+    return measure(repeat, [] {}, function);
+}
+
+Surface_mesh load_surface_mesh(const std::string& filename)
+{
+    auto [mesh, texture_path] = import_surface_mesh(filename);
+
+    CGAL::Polygon_mesh_processing::stitch_borders(mesh);
+
+    return mesh;
+}
+
+// Compare Surface_mesh et Flat_mesh sur l'annotation et la projection de M1 sur M2
+void bench_representation(const std::string& M1_filename,
+                          const std::string& M2_filename, double threshold,
+                          size_t repeat)
+{
+    Surface_mesh M1 = load_surface_mesh(M1_filename);
+    Surface_mesh M2 = load_surface_mesh(M2_filename);
+
+    auto [M2_normal_map, M2_normal_map_exist] =
+        M2.property_map<Surface_mesh::Vertex_index, Kernel::Vector_3>("v:normal");
+
+    if(!M2_normal_map_exist)
+    {
+        std::cerr << "[ERROR] " << M2_filename << " has no vertex normals\n";
+        exit(EXIT_FAILURE);
+    }
+
+    SM_kd_tree M2_tree(M2.vertices().begin(), M2.vertices().end(),
+                       SM_kd_tree_splitter(),
+                       SM_kd_tree_traits_adapter(M2.points()));
+    M2_tree.build();
+
+    std::cout << "[BENCH] " << M1_filename << " (" << M1.number_of_vertices()
+              << " vertices) on " << M2_filename << " ("
+              << M2.number_of_vertices() << " vertices)\n";
+
+    // Annotation
+
+    Surface_mesh M1_marked;
+    Flat_mesh M1_flat;
+
+    double sm_marking = measure(
+        repeat, [&] { M1_marked = M1; },
+        [&] { mark_delimited_regions(M1_marked, M2_tree, threshold, threshold); });
+
+    double flat_build = measure(repeat, [&] { M1_flat = make_flat_mesh(M1); });
+
+    double flat_marking = measure(repeat, [&] {
+        mark_delimited_regions(M1_flat, M2_tree, threshold, threshold);
+    });
+
+    auto M1_marks = get_marking_map(M1_marked);
+
+    size_t mismatches = 0;
+
+    for(size_t i = 0; i < M1_flat.size(); ++i)
+    {
+        if(M1_marks[M1_flat.vertices[i]] != M1_flat.marks[i])
+            ++mismatches;
+    }
+
+    // Projection
+
+    Surface_mesh M1_projected;
+    Flat_mesh M1_flat_projected;
+
+    double sm_projection = measure(repeat, [&] {
+        M1_projected = projection(M1, M1.vertices(), M2_tree, M2_normal_map);
+    });
+
+    Flat_mesh M2_flat = make_flat_mesh(M2);
+
+    double flat_projection = measure(
+        repeat, [&] { M1_flat_projected = M1_flat; },
+        [&] { projection(M1_flat_projected, M2_flat, M2_tree); });
+
+    std::cout << "  flat mesh construction      : " << flat_build << " ms\n";
+    std::cout << "  marking    (Surface_mesh)   : " << sm_marking << " ms\n";
+    std::cout << "  marking    (Flat_mesh)      : " << flat_marking << " ms\n";
+    std::cout << "  projection (Surface_mesh)   : " << sm_projection << " ms\n";
+    std::cout << "  projection (Flat_mesh)      : " << flat_projection << " ms\n";
+    std::cout << "  marking mismatches          : " << mismatches << '\n';
+}
+
+// Mesure le débit (poids par seconde) de chaque noyau sur des voisinages aléatoires de K points,
+// pour le noyau compilé et pour l'évaluation historique par Weight_kernel::weight.
+void bench_kernels(size_t nb_neighborhoods, unsigned int K, size_t repeat)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(1e-3, 1.0);
+
+    std::vector<APSS_neighborhood> neighborhoods(nb_neighborhoods);
+    std::vector<double> radii(nb_neighborhoods);
+
+    for(size_t i = 0; i < nb_neighborhoods; ++i)
+    {
+        neighborhoods[i].resize(K);
+
+        for(auto& sqr_dist : neighborhoods[i].sqr_dist)
+            sqr_dist = distribution(generator);
+
+        radii[i] = std::sqrt(*std::max_element(neighborhoods[i].sqr_dist.begin(),
+                                               neighborhoods[i].sqr_dist.end()));
+    }
+
+    const std::pair<const char*, Weight_kernel::Type> types[] = {
+        {"gaussian", Weight_kernel::Type::Gaussian},
+        {"wendland", Weight_kernel::Type::Wendland},
+        {"singular", Weight_kernel::Type::Singular},
+        {"uniform", Weight_kernel::Type::Uniform}};
+
+    const double nb_weights = static_cast<double>(nb_neighborhoods) * K;
+
+    std::cout << "[BENCH] " << nb_neighborhoods << " neighborhoods of " << K
+              << " points (Mweights/s)\n";
+
+    for(auto [name, type] : types)
+    {
+        Weight_kernel weight_kernel{type, Weight_kernel::Mode::Adaptive, 0, 2};
+
+        // Évaluation historique : un appel (avec branchements et std::pow) par poids
+        double runtime = measure(repeat, [&] {
+            for(size_t i = 0; i < nb_neighborhoods; ++i)
+            {
+                auto& neighborhood = neighborhoods[i];
+
+                for(size_t j = 0; j < neighborhood.size(); ++j)
+                    neighborhood.w[j] = weight_kernel.weight(
+                        std::sqrt(neighborhood.sqr_dist[j]), radii[i]);
+            }
+        });
+
+        double compiled = measure(repeat, [&] {
+            dispatch_weight_kernel(weight_kernel, [&](const auto& kernel) {
+                for(size_t i = 0; i < nb_neighborhoods; ++i)
+                    kernel.compute_weights(neighborhoods[i], radii[i]);
+            });
+        });
+
+        std::cout << "  " << name << " : " << nb_weights / (runtime * 1e3)
+                  << " (Weight_kernel) / " << nb_weights / (compiled * 1e3)
+                  << " (compiled)\n";
+    }
+}
+
+// Vérifie la précision de kernel_exp par rapport à std::exp : erreur relative maximale sur une
+// grille de [-1, 0] (arguments du mode Adaptive), une grille de [-700, 0] et 'samples' arguments
+// aléatoires de [-700, 0], puis l'égalité au bit près de gaussian_weights (AVX2 si disponible) et
+// gaussian_weights_scalar. Renvoie faux si la borne kernel_exp_max_relative_error est dépassée.
+bool check_kernel_accuracy(size_t samples)
+{
+    auto relative_error = [](double x) {
+        double expected = std::exp(x);
+        return std::abs(kernel_exp(x) - expected) / expected;
+    };
+
+    auto max_relative_error = [&](double min, double max, size_t count) {
+        double error = 0;
+
+        for(size_t i = 0; i <= count; ++i)
+            error = std::max(error, relative_error(min + (max - min) * static_cast<double>(i) /
+                                                             static_cast<double>(count)));
+
+        return error;
+    };
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(-700.0, 0.0);
+
+    std::vector<double> arguments(samples);
+
+    for(auto& x : arguments)
+        x = distribution(generator);
+
+    double random_error = 0;
+
+    for(double x : arguments)
+        random_error = std::max(random_error, relative_error(x));
+
+    const std::pair<const char*, double> errors[] = {
+        {"[-1, 0]   (grid)  ", max_relative_error(-1.0, 0.0, 1000000)},
+        {"[-700, 0] (grid)  ", max_relative_error(-700.0, 0.0, 1000000)},
+        {"[-700, 0] (random)", random_error}};
+
+    bool success = true;
+
+    std::cout << "[CHECK] kernel_exp relative error (bound " << kernel_exp_max_relative_error
+              << ")\n";
+
+    for(auto [range, error] : errors)
+    {
+        std::cout << "  " << range << " : " << error << '\n';
+        success = success && error <= kernel_exp_max_relative_error;
+    }
+
+    // Les arguments -d^2 / r^2 sont obtenus avec r = 1
+    std::vector<double> sqr_dist(arguments.size());
+
+    for(size_t i = 0; i < arguments.size(); ++i)
+        sqr_dist[i] = -arguments[i];
+
+    std::vector<double> w(samples), w_scalar(samples);
+
+    gaussian_weights(sqr_dist.data(), w.data(), samples, 1.0);
+    gaussian_weights_scalar(sqr_dist.data(), w_scalar.data(), samples, 1.0);
+
+    size_t mismatches = 0;
+
+    for(size_t i = 0; i < samples; ++i)
+        mismatches += std::memcmp(&w[i], &w_scalar[i], sizeof(double)) != 0;
+
+    std::cout << "  gaussian_weights mismatches (" << (has_avx2_kernels() ? "AVX2" : "scalar")
+              << " / scalar) : " << mismatches << '\n';
+
+    return success && mismatches == 0;
+}
+
+// Compare le lecteur natif (mesh/reader.hpp) et assimp sur la construction d'une Surface_mesh :
+// temps de chargement et pic de mémoire résidente au-dessus de la mémoire avant chargement.
+void bench_load(const std::string& filename, size_t repeat)
+{
+    if(!has_native_reader(filename))
+    {
+        std::cerr << "[WARNING] " << filename << " has no native reader\n";
+        return;
+    }
+
+    // Le pic ne peut être remis à zéro que sous linux, sinon seul le premier chargement
+    // mesuré est significatif
+    if(!reset_peak_memory_usage())
+        std::cerr << "[WARNING] peak memory cannot be reset on this system\n";
+
+    size_t vertices = 0;
+    size_t peak     = 0;
+
+    auto measure_peak = [&](auto&& load) {
+        reset_peak_memory_usage();
+        size_t baseline = current_memory_usage();
+
+        load();
+
+        size_t load_peak = peak_memory_usage();
+        peak = load_peak > baseline ? load_peak - baseline : 0;
+    };
+
+    double native = measure(repeat, [&] {
+        measure_peak([&] {
+            auto mesh_data = read_mesh_data(filename);
+
+            if(!mesh_data)
+            {
+                std::cerr << "[ERROR] native reader failed on " << filename << '\n';
+                exit(EXIT_FAILURE);
+            }
+
+            vertices = to_surface_mesh(*mesh_data).number_of_vertices();
+        });
+    });
+
+    size_t native_peak     = peak;
+    size_t native_vertices = vertices;
+
+    double assimp = measure(repeat, [&] {
+        measure_peak([&] {
+            auto scene = import_scene(filename);
+            vertices =
+                make_surface_mesh(scene->mMeshes[find_mesh_index(scene.get())])
+                    .number_of_vertices();
+        });
+    });
+
+    size_t assimp_peak     = peak;
+    size_t assimp_vertices = vertices;
+
+    std::cout << "[BENCH] loading " << filename << '\n';
+
+    // Projection en mémoire (PLY binaires) : seul l'en-tête et les faces sont lus
+    if(map_ply(filename))
+    {
+        double mapped = measure(repeat, [&] {
+            measure_peak([&] { vertices = map_ply(filename)->number_of_vertices; });
+        });
+
+        std::cout << "  mapped : " << mapped << " ms, " << peak / (1 << 20)
+                  << " MiB peak, " << vertices << " vertices\n";
+    }
+
+    std::cout << "  native : " << native << " ms, " << native_peak / (1 << 20)
+              << " MiB peak, " << native_vertices << " vertices\n";
+    std::cout << "  assimp : " << assimp << " ms, " << assimp_peak / (1 << 20)
+              << " MiB peak, " << assimp_vertices << " vertices\n";
+}
+
+// Mesure la conversion d'un maillage vers Mesh_data (affichage) et aiMesh (exportation), avec des
+// index CGAL déjà denses puis avec un sommet effacé (renumérotation par tableau, cf. indexing.hpp)
+void bench_conversion(const std::string& filename, size_t repeat)
+{
+    Surface_mesh mesh = load_surface_mesh(filename);
+
+    Surface_mesh garbage_mesh = mesh;
+    garbage_mesh.remove_vertex(garbage_mesh.add_vertex(Kernel::Point_3(0, 0, 0)));
+
+    size_t faces = 0;
+
+    auto mesh_data_time = [&](const Surface_mesh& M) {
+        return measure(repeat, [&] {
+            faces = to_mesh_data(M).triangulated_faces->size();
+        });
+    };
+
+    auto ai_mesh_time = [&](const Surface_mesh& M) {
+        return measure(repeat, [&] { faces = make_ai_mesh(M)->mNumFaces; });
+    };
+
+    std::cout << "[BENCH] conversion of " << filename << " ("
+              << mesh.number_of_vertices() << " vertices, "
+              << mesh.number_of_faces() << " faces)\n";
+    std::cout << "  to_mesh_data           : " << mesh_data_time(mesh) << " ms\n";
+    std::cout << "  to_mesh_data (garbage) : " << mesh_data_time(garbage_mesh) << " ms\n";
+    // Conversion vers un tampon entrelacé fourni par l'appelant (ex: buffer OpenGL projeté)
+    Interleaved_layout layout = interleaved_layout(mesh);
+    std::vector<char> vertices(mesh.number_of_vertices() * layout.stride);
+    std::vector<unsigned int> indices(3 * mesh.number_of_faces());
+
+    double interleaved = measure(repeat, [&] {
+        write_interleaved_vertices(mesh, layout, vertices.data());
+        faces = write_triangles(mesh, indices.data());
+    });
+
+    std::cout << "  interleaved buffer     : " << interleaved << " ms\n";
+    std::cout << "  make_ai_mesh           : " << ai_mesh_time(mesh) << " ms\n";
+    std::cout << "  make_ai_mesh (garbage) : " << ai_mesh_time(garbage_mesh) << " ms\n";
+}
+
+// Compare le chargement des fichiers un par un et par le Mesh_loader (un thread par fichier),
+// décodage des textures compris
+void bench_load_files(const std::vector<std::string>& filenames, size_t repeat)
+{
+    auto load_all = [&](unsigned int nb_threads) {
+        Mesh_loader loader(filenames, {}, false, nb_threads);
+
+        while(loader.pop())
+            ;
+    };
+
+    double sequential = measure(repeat, [&] { load_all(1); });
+    double parallel   = measure(repeat, [&] { load_all(0); });
+
+    std::cout << "[BENCH] loading " << filenames.size() << " files\n";
+    std::cout << "  sequential : " << sequential << " ms\n";
+    std::cout << "  parallel   : " << parallel << " ms\n";
+}
+
+static const char USAGE[] =
+    R"(Benchmarks of the mesh processing kernels.
+
+    Usage:
+      bench representation [options] <threshold> <input-files>...
+      bench kernels [options]
+      bench accuracy [options]
+      bench load [options] <input-files>...
+      bench conversion [options] <input-files>...
+
+    Commands:
+      representation    Compare Surface_mesh and Flat_mesh on marking and projection
+                        of each input file on the next one.
+      kernels           Measure the throughput of each APSS weight kernel.
+      accuracy          Check the relative error of the exponential of the gaussian kernel
+                        against std::exp, fails if it exceeds the documented bound.
+      load              Compare the native PLY/OBJ reader with assimp (load time and peak memory),
+                        then the sequential and parallel loading of all the input files.
+      conversion        Measure the conversion of each input file to Mesh_data, to an
+                        interleaved vertex buffer and to aiMesh.
+
+    Options:
+      -r <count>, --repeat <count>     Number of runs, the best one is reported [default: 3].
+      -t <count>, --threads <count>    Number of threads used for processing (0 = all cores) [default: 0].
+      -n <count>, --samples <count>    Number of neighborhoods (kernels) or random arguments (accuracy) [default: 100000].
+      -k <count>, --neighbors <count>  Number of points per neighborhood [default: 20].
+      -h --help                        Show this screen
+      --version                        Show version
+)";
+
+int main(int argc, char const* argv[])
+{
+    std::map<std::string, docopt::value> args =
+        docopt::docopt(USAGE, {argv + 1, argv + argc}, true, "v1.0");
+
+    size_t repeat  = 1;
+    size_t samples = 1;
+    unsigned int K = 1;
+
+    try
+    {
+        repeat  = std::max(std::stoi(args.at("--repeat").asString()), 1);
+        samples = std::max(std::stoi(args.at("--samples").asString()), 1);
+        K       = static_cast<unsigned int>(
+            std::max(std::stoi(args.at("--neighbors").asString()), 1));
+        set_number_of_threads(static_cast<unsigned int>(
+            std::max(std::stoi(args.at("--threads").asString()), 0)));
+    }
+    catch(std::invalid_argument& ia)
+    {
+        std::cerr << "[ERROR] --repeat, --threads, --samples and --neighbors must be integers\n";
+        exit(EXIT_FAILURE);
+    }
+
+    if(args.at("kernels").asBool())
+        bench_kernels(samples, K, repeat);
+
+    if(args.at("accuracy").asBool() && !check_kernel_accuracy(samples))
+        return EXIT_FAILURE;
+
+    if(args.at("load").asBool())
+    {
+        auto input_files = args.at("<input-files>").asStringList();
+
+        for(const auto& filename : input_files)
+            bench_load(filename, repeat);
+
+        if(input_files.size() > 1)
+            bench_load_files(input_files, repeat);
+    }
+
+    if(args.at("conversion").asBool())
+    {
+        for(const auto& filename : args.at("<input-files>").asStringList())
+            bench_conversion(filename, repeat);
+    }
+
+    if(args.at("representation").asBool())
+    {
+        auto input_files = args.at("<input-files>").asStringList();
+
+        double threshold = 0;
+
+        try
+        {
+            threshold = std::stod(args.at("<threshold>").asString());
+        }
+        catch(std::invalid_argument& ia)
+        {
+            std::cerr << "[ERROR] <threshold> must be a reals numbers\n";
+            exit(EXIT_FAILURE);
+        }
+
+        for(size_t i = 1; i < input_files.size(); ++i)
+            bench_representation(input_files[i - 1], input_files[i], threshold, repeat);
+    }
+
+    return EXIT_SUCCESS;
+}
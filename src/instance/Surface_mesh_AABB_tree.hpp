@@ -0,0 +1,28 @@
+#ifndef INSTANCE_SURFACE_MESH_AABB_TREE_HPP
+#define INSTANCE_SURFACE_MESH_AABB_TREE_HPP
+
+#include "Surface_mesh.hpp"
+
+// CGAL
+#include <CGAL/AABB_face_graph_triangle_primitive.h>
+#include <CGAL/AABB_tree.h>
+#include <CGAL/version_macros.h>
+
+#if CGAL_VERSION_NR >= CGAL_VERSION_NUMBER(6, 0, 0)
+#include <CGAL/AABB_traits_3.h>
+#else
+#include <CGAL/AABB_traits.h>
+#endif
+
+// Arbre de boites englobantes sur les faces (triangulaires) d'une Surface_mesh
+using SM_AABB_primitive = CGAL::AABB_face_graph_triangle_primitive<Surface_mesh>;
+
+#if CGAL_VERSION_NR >= CGAL_VERSION_NUMBER(6, 0, 0)
+using SM_AABB_traits = CGAL::AABB_traits_3<Kernel, SM_AABB_primitive>;
+#else
+using SM_AABB_traits = CGAL::AABB_traits<Kernel, SM_AABB_primitive>;
+#endif
+
+using SM_AABB_tree = CGAL::AABB_tree<SM_AABB_traits>;
+
+#endif // INSTANCE_SURFACE_MESH_AABB_TREE_HPP
@@ -5,9 +5,13 @@
 
 // CGAL
 #include <CGAL/K_neighbor_search.h>
+#include <CGAL/Orthogonal_k_neighbor_search.h>
 #include <CGAL/Search_traits_3.h>
 #include <CGAL/Search_traits_adapter.h>
 
+// STD
+#include <type_traits>
+
 using SM_kd_tree_traits			= CGAL::Search_traits_3<Kernel>;
 using SM_kd_tree_traits_adapter = CGAL::Search_traits_adapter<
 	Surface_mesh::Vertex_index,
@@ -18,4 +22,10 @@ using SM_kd_tree		  = SM_kd_tree_search::Tree;
 using SM_kd_tree_distance = SM_kd_tree_search::Distance;
 using SM_kd_tree_splitter = SM_kd_tree_search::Splitter;
 
+// Recherche spécialisée pour la distance euclidienne, plus rapide pour les petits K (ex: K = 1)
+using SM_kd_tree_orthogonal_search = CGAL::Orthogonal_k_neighbor_search<SM_kd_tree_traits_adapter>;
+
+static_assert(std::is_same<SM_kd_tree_orthogonal_search::Tree, SM_kd_tree>::value,
+			  "both searches must share the same kd-tree type");
+
 #endif // INSTANCE_SURFACE_MESH_KD_TREE_HPP
\ No newline at end of file
@@ -1,13 +1,28 @@
 // STD
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
 
 // PROJECT
 #include "docopt/docopt.h"
 #include "mesh/conversion.hpp"
 #include "mesh/export.hpp"
 #include "mesh/import.hpp"
+#include "mesh/indexing.hpp"
+#include "mesh/location.hpp"
 #include "mesh/marking.hpp"
+#include "mesh/parallel.hpp"
+#include "mesh/profiling.hpp"
+#include "mesh/result.hpp"
 #include "mesh/projection.hpp"
+#include "mesh/search.hpp"
 #include "mesh/utils.hpp"
 #include "mesh/viewer.hpp"
 
@@ -36,105 +51,115 @@ Vertex_mark triangle_mark(const VertexRange& triangle_vertices,
     return Vertex_mark::Limit;
 }
 
-// Vérifie si le point 'p' se projette sur les sommets de 'triangle_vertices'
-template <class VertexRange>
-bool is_point_projected_on_triangle(const Surface_mesh& mesh,
-                                    const VertexRange& triangle_vertices,
-                                    const Kernel::Point_3& p)
+// Projection d'un maillage réduite à ses positions (cf. try_project_points) : le
+// sommet v du maillage se projette en points[index[v]]. La projection partage
+// la connectivité, l'adjacence et les annotations du maillage, qui ne sont donc
+// pas copiées.
+struct Projected_vertices
 {
-    if(triangle_vertices.size() != 3)
+    std::vector<Kernel::Point_3> points; // dans l'ordre de mesh.vertices()
+    Dense_vertex_index index;
+
+    const Kernel::Point_3& point(Surface_mesh::Vertex_index v) const
     {
-        std::cerr
-            << "[ERROR] triangle_vertices must be of size 3 but is of size "
-            << triangle_vertices.size() << '\n';
-        exit(EXIT_FAILURE);
+        return points[index[v]];
     }
+};
 
-    // Get triangle points
-
-    auto v_it = triangle_vertices.begin();
-
-    auto a = mesh.point(*v_it);
-    ++v_it;
-    auto b = mesh.point(*v_it);
-    ++v_it;
-    auto c = mesh.point(*v_it);
-
-    // Create triangle
-
-    Kernel::Triangle_3 triangle(a, b, c);
-
-    // Create triangle perpendicular line
+// Cette algorithme copy les annotation de M2 sur M1 : chaque sommet de M1 reçoit
+// l'annotation du triangle de M2 le plus proche de sa projection M1_proj (cf.
+// triangle_mark). Les sommets qui se projettent hors de ce triangle (au delà du
+// bord de M2) restent Vertex_mark::None.
+// Precondition : M1_proj doit être la projection de M1 sur M2
+// Renvoie une erreur (sans modifier M1) si M2 n'a pas de carte d'annotation
+// associée (SM_marking_map)
+Result<SM_marking_map> try_mark_regions(Surface_mesh& M1,
+                                        const Projected_vertices& M1_proj,
+                                        const Surface_mesh& M2,
+                                        const SM_face_locator& M2_locator)
+{
+    auto checked_M2_marking_map = try_get_marking_map(M2);
 
-    auto perpendicular_line = triangle.supporting_plane().perpendicular_line(p);
+    if(!checked_M2_marking_map)
+        return checked_M2_marking_map;
 
-    return CGAL::do_intersect(perpendicular_line, triangle);
-}
+    auto M2_marking_map = *checked_M2_marking_map;
 
-// Cette algorithme copy les annotation de M2 sur M1
-// Precondition 1 : M1 doit d'abord etre projeté sur M2
-// Precondition 2 : M2 doit avoir un carte d'annotation associé (SM_marking_map)
-SM_marking_map mark_regions(Surface_mesh& M1, const Surface_mesh& M2,
-                            const SM_kd_tree& M2_tree)
-{
     auto [M1_marking_map, created] =
         M1.add_property_map<Surface_mesh::Vertex_index, Vertex_mark>(
             "v:mark", Vertex_mark::None);
 
-    auto M2_marking_map = get_marking_map(M2);
+    std::vector<Surface_mesh::Vertex_index> vertices(M1.vertices().begin(),
+                                                     M1.vertices().end());
 
-    for(auto M1_v : M1.vertices())
-    {
-        auto M1_point = M1.point(M1_v);
+    std::atomic<size_t> nb_outside{0};
 
-        SM_kd_tree_search search(M2_tree, M1_point, 1, 0, true,
-                                 M2_tree.traits().point_property_map());
+    // Une seule requête par sommet, chaque thread écrit dans des cases
+    // distinctes de la carte d'annotation
+    parallel_for_chunks(vertices.size(), [&](size_t begin, size_t end) {
+        size_t chunk_outside = 0;
 
-        auto [M2_v, M2_dist_squared1] = *(search.begin());
-
-        auto faces = CGAL::halfedges_around_target(M2_v, M2);
-
-        for(auto ff : faces)
+        for(size_t i = begin; i < end; ++i)
         {
-            auto faces_around_face = CGAL::halfedges_around_target(ff, M2);
+            auto location = M2_locator.locate(M1_proj.point(vertices[i]));
 
-            for(auto f : faces_around_face)
+            if(location.face == Surface_mesh::null_face())
+                continue;
+
+            if(!is_projected_inside_triangle(location.coordinates))
             {
-                if(M2.is_border(f))
-                {
-                    // std::cerr << "[WARNING] skipping border halfedge\n";
-                    continue;
-                }
-
-                auto M2_triangle_vertices = CGAL::vertices_around_face(f, M2);
-
-                if(is_point_projected_on_triangle(M2, M2_triangle_vertices,
-                                                  M1_point))
-                {
-                    M1_marking_map[M1_v] =
-                        triangle_mark(M2_triangle_vertices, M2_marking_map);
-                    break;
-                }
+                ++chunk_outside;
+                continue;
             }
+
+            M1_marking_map[vertices[i]] = triangle_mark(
+                CGAL::vertices_around_face(M2.halfedge(location.face), M2),
+                M2_marking_map);
         }
-    }
+
+        nb_outside += chunk_outside;
+    });
+
+    // Ces sommets se projettent hors de M2 (au delà de son bord) : ils ne
+    // sont pas annotés
+    if(nb_outside > 0)
+        std::clog << "[STATUS] " << nb_outside
+                  << " vertices projected outside of the mesh border\n";
 
     return M1_marking_map;
 }
 
-SM_marking_map mark_regions(Surface_mesh& M1, const Surface_mesh& M2)
+// Comme ci-dessus, renvoie aussi une erreur si M2 est vide (avant de construire
+// son localisateur)
+Result<SM_marking_map> try_mark_regions(Surface_mesh& M1,
+                                        const Projected_vertices& M1_proj,
+                                        const Surface_mesh& M2)
 {
-    SM_kd_tree M2_tree(M2.vertices().begin(), M2.vertices().end(),
-                       SM_kd_tree_splitter(),
-                       SM_kd_tree_traits_adapter(M2.points()));
+    if(M2.number_of_vertices() == 0)
+        return Error{"empty mesh"};
+
+    auto M2_marking_map = try_get_marking_map(M2);
+
+    // Pas de localisateur (AABB tree) construit pour rien si M2 n'est pas annoté
+    if(!M2_marking_map)
+        return M2_marking_map;
 
-    return mark_regions(M1, M2, M2_tree);
+    SM_face_locator M2_locator(M2);
+
+    return try_mark_regions(M1, M1_proj, M2, M2_locator);
 }
 
-SM_marking_map mark_delimited_regions(Surface_mesh& M1, const Surface_mesh& M2)
+Result<SM_marking_map> try_mark_delimited_regions(Surface_mesh& M1,
+                                                  const Projected_vertices& M1_proj,
+                                                  const Vertex_adjacency& M1_adjacency,
+                                                  const Surface_mesh& M2)
 {
-    mark_regions(M1, M2);
-    return mark_limits(M1);
+    auto M1_marking_map = try_mark_regions(M1, M1_proj, M2);
+
+    if(!M1_marking_map)
+        return M1_marking_map;
+
+    return mark_limits(*M1_marking_map, M1_adjacency);
 }
 
 struct Scene_data
@@ -148,17 +173,26 @@ struct Scene_data
     std::string extension;
 };
 
-Scene_data import_scene_data(const std::string& filename)
+Result<Scene_data> import_scene_data(const std::string& filename)
 {
     //  Importing scene data from file
-    auto scene = import_scene(filename);
+    auto imported_scene = try_import_scene(filename);
+
+    if(!imported_scene)
+        return Error{imported_scene.error()};
+
+    auto scene = std::move(*imported_scene);
 
     // Check scene status
     print_scene_status(scene.get());
 
     // Finding mesh data from scene
     unsigned int mesh_index = find_mesh_index(scene.get());
-    aiMesh* mesh            = scene->mMeshes[mesh_index];
+
+    if(mesh_index == std::numeric_limits<unsigned int>::max())
+        return Error{filename + " does not contain any triangle mesh"};
+
+    aiMesh* mesh = scene->mMeshes[mesh_index];
 
     // Finding mesh material index
     unsigned int material_index = mesh->mMaterialIndex;
@@ -183,24 +217,63 @@ Scene_data import_scene_data(const std::string& filename)
         extension = "obj"; // force obj output
     }
 
-    return {std::move(scene), mesh_index,    mesh,     material_index,
-            material,         textures_path, extension};
+    return Scene_data{std::move(scene), mesh_index,    mesh,     material_index,
+                      material,         textures_path, extension};
 }
 
-void update_scene_mesh_data(Scene_data& scene_data, const Surface_mesh& mesh)
+// Fichier importé par un thread de chargement : la scène assimp est conservée pour l'export
+struct Loaded_scene
 {
+    Scene_data scene_data;
+    Surface_mesh mesh;
+};
+
+Result<Loaded_scene> load_scene(const std::string& filename)
+{
+    auto scene_data = import_scene_data(filename);
+
+    if(!scene_data)
+        return Error{scene_data.error()};
+
+    Surface_mesh mesh = make_surface_mesh(scene_data->mesh);
+
+    // WARNING: force mesh to be geometricaly processable by removing duplicated
+    // halfedges
+    CGAL::Polygon_mesh_processing::stitch_borders(mesh);
+
+    return Loaded_scene{std::move(*scene_data), std::move(mesh)};
+}
+
+// Lance l'importation d'un fichier dans un thread séparé
+std::future<Result<Loaded_scene>> prefetch_scene(const std::string& filename)
+{
+    return std::async(std::launch::async, load_scene, filename);
+}
+
+void update_scene_mesh_data(Scene_data& scene_data, const Surface_mesh& mesh,
+                            bool optimize)
+{
+    auto ai_mesh = make_ai_mesh(mesh);
+
+    if(optimize)
+    {
+        auto [acmr_before, acmr_after] = optimize_ai_mesh(*ai_mesh);
+        std::clog << "[STATUS] ACMR: " << acmr_before << " -> " << acmr_after
+                  << '\n';
+    }
+
     delete scene_data.scene->mMeshes[scene_data.mesh_index];
 
-    scene_data.scene->mMeshes[scene_data.mesh_index] =
-        make_ai_mesh(mesh).release();
+    scene_data.scene->mMeshes[scene_data.mesh_index] = ai_mesh.release();
     scene_data.scene->mMeshes[scene_data.mesh_index]->mMaterialIndex =
         scene_data.material_index;
 }
 
 // export scene by modifying scene_data
-aiReturn export_scene_data(Scene_data& scene_data, const std::string& filename)
+Status export_scene_data(Scene_data& scene_data, const std::string& filename)
 {
-    return export_scene(scene_data.extension, filename, scene_data.scene.get());
+    return try_export_scene(scene_data.extension, filename,
+                            scene_data.scene.get());
 }
 
 // Précondition : (dist_close >= 0 && dist_distant >= 0)
@@ -213,29 +286,37 @@ double reprojection_coeff(double dist_close, double dist_distant)
            (dist_close + dist_distant);
 }
 
-// Reprojette certains sommet en fonction de leurs distances par rapport au
-// point proches et distants du maillages
+// Reprojette en place certains sommet en fonction de leurs distances par
+// rapport au point proches et distants du maillages. Renvoie une erreur (sans
+// rien modifier) si l'une des deux régions n'a aucun sommet limite.
 template <class VertexRange>
-Surface_mesh reprojection(const Surface_mesh& M1, const VertexRange& M1_vertices,
-                  const Surface_mesh& M1_proj, const SM_kd_tree& close_tree,
-                  const SM_kd_tree& distant_tree)
+Status try_reproject(Surface_mesh& M1, const VertexRange& M1_vertices,
+                     const Projected_vertices& M1_proj, const SM_kd_tree& close_tree,
+                     const SM_kd_tree& distant_tree)
 {
-    Surface_mesh result(M1);
+    // Les arbres indexent les points de M1 : toutes les distances sont
+    // calculées avant de déplacer le moindre sommet
+    auto nearest_close = try_nearest_vertices(M1, M1_vertices, close_tree);
 
-    for(auto M1_v : M1_vertices)
-    {
-        auto M1_point = result.point(M1_v);
+    if(!nearest_close)
+        return Error{"reprojection without close limit vertices : " +
+                     nearest_close.error()};
 
-        SM_kd_tree_search search_close(
-            close_tree, M1_point, 1, 0, true,
-            close_tree.traits().point_property_map());
+    auto nearest_distant = try_nearest_vertices(M1, M1_vertices, distant_tree);
 
-        SM_kd_tree_search search_distant(
-            distant_tree, M1_point, 1, 0, true,
-            distant_tree.traits().point_property_map());
+    if(!nearest_distant)
+        return Error{"reprojection without distant limit vertices : " +
+                     nearest_distant.error()};
 
-        auto [close_v, close_dist_squared]     = *(search_close.begin());
-        auto [distant_v, distant_dist_squared] = *(search_distant.begin());
+    size_t i = 0;
+
+    for(auto M1_v : M1_vertices)
+    {
+        auto M1_point = M1.point(M1_v);
+
+        double close_dist_squared   = (*nearest_close)[i].squared_distance;
+        double distant_dist_squared = (*nearest_distant)[i].squared_distance;
+        ++i;
 
         double k = reprojection_coeff(std::sqrt(close_dist_squared),
                                       std::sqrt(distant_dist_squared));
@@ -244,20 +325,22 @@ Surface_mesh reprojection(const Surface_mesh& M1, const VertexRange& M1_vertices
 
         Kernel::Vector_3 v = (M1_proj_point - M1_point) * k;
 
-        result.point(M1_v) = (M1_point + v);
+        M1.point(M1_v) = (M1_point + v);
     }
 
-    return result;
+    return {};
 }
 
+// 'adjacency' est l'adjacence de M1, annoté d'après sa projection M1_proj
 template <class VertexRange>
-Surface_mesh reprojection(const Surface_mesh& M1, const VertexRange& M1_vertices,
-                  const Surface_mesh& M1_proj)
+Status try_reproject(Surface_mesh& M1, const VertexRange& M1_vertices,
+                     const Projected_vertices& M1_proj, const Vertex_adjacency& adjacency)
 {
-    auto close_limit_vertices =
-        marked_vertices(M1_proj, Vertex_mark::Limit, Vertex_mark::Close);
-    auto distant_limit_vertices =
-        marked_vertices(M1_proj, Vertex_mark::Limit, Vertex_mark::Distant);
+    // Les arbres sont construits directement à partir des sélections
+    auto close_limit_vertices = marked_selection(
+        M1, adjacency, Vertex_mark::Limit, Vertex_mark::Close);
+    auto distant_limit_vertices = marked_selection(
+        M1, adjacency, Vertex_mark::Limit, Vertex_mark::Distant);
 
     SM_kd_tree close_tree(close_limit_vertices.begin(),
                           close_limit_vertices.end(), SM_kd_tree_splitter(),
@@ -267,106 +350,134 @@ Surface_mesh reprojection(const Surface_mesh& M1, const VertexRange& M1_vertices
                             distant_limit_vertices.end(), SM_kd_tree_splitter(),
                             SM_kd_tree_traits_adapter(M1.points()));
 
-    return reprojection(M1, M1_vertices, M1_proj, close_tree, distant_tree);
+    return try_reproject(M1, M1_vertices, M1_proj, close_tree, distant_tree);
 }
 
-Surface_mesh reproject_transition(const Surface_mesh& M1, const Surface_mesh& M1_proj)
+// Adapte en place la géométrie de M1 autour des transitions de sa projection
+// Precondition : M1 doit être annoté d'après M1_proj (cf. try_mark_delimited_regions)
+Status try_reproject_transition(Surface_mesh& M1, const Projected_vertices& M1_proj,
+                                const Vertex_adjacency& adjacency)
 {
-    return reprojection(M1, limit_vertices(M1_proj), M1_proj);
+    return try_reproject(M1, limit_vertices(M1), M1_proj, adjacency);
+}
+
+// Affiche le pic de mémoire résidente atteint depuis l'étape précédente, puis
+// remet le pic à zéro (sous linux seulement, ailleurs le pic est global)
+void report_memory(const char* stage)
+{
+    const double MiB = 1024.0 * 1024.0;
+
+    std::clog << "[STATUS] memory after " << stage << " : peak "
+              << peak_memory_usage() / MiB << " MiB, current "
+              << current_memory_usage() / MiB << " MiB\n";
+
+    reset_peak_memory_usage();
 }
 
 static const char USAGE[] =
     R"(Create a new mesh by matching parts of multiple similars meshes.
 
-    Usage: match [options] <threshold> <input-files>...
+    Usage:
+      match [options] <threshold> <input-files>...
+      match [options] --batch <file>
 
     Options:
       -c, --colorize                       Colorize geometrical objects by files.
       -e <offset>, --epsilon <offest>	   Augment threshold to make transition regions.
       -a, --export-all                     Export all meshes components
+      -t <count>, --threads <count>        Number of threads used for processing (0 = all cores) [default: 0].
+      -k <type>, --kernel <type>           APSS weight kernel: gaussian, wendland, singular or uniform [default: gaussian].
+      -s <exp>, --singular-exponent <exp>  Exponent s of the singular kernel (r / d)^s [default: 2].
+      -m <mode>, --radius-mode <mode>      APSS kernel radius: adaptive (farthest neighbor), max (at least --radius)
+                                           or constant (always --radius) [default: adaptive].
+      -r <dist>, --radius <dist>           Kernel radius of the max and constant modes [default: 0].
+      -o, --optimize                       Reorder exported triangles and vertices for the GPU vertex cache.
+      -b <file>, --batch <file>            Process every job of <file> ("<threshold> <input-files>..." per line) in this process.
       -h --help                            Show this screen
       --version                            Show version
 )";
 
-int main(int argc, char const* argv[])
+// Un appariement : les fichiers exportés sont préfixés par 'output_prefix'
+struct Match_job
 {
-    std::map<std::string, docopt::value> args =
-        docopt::docopt(USAGE, {argv + 1, argv + argc}, true, "v1.0");
-
-    ////// PROGRAM ARGUMENTS
-
-    double threshold = 0;
-    // double reproject_offest = thres
-
-    try
-    {
-        threshold = std::stod(args.at("<threshold>").asString());
-    }
-    catch(std::invalid_argument& ia)
-    {
-        std::cerr << "[ERROR] <threshold> must be a reals numbers\n";
-        exit(EXIT_FAILURE);
-    }
-
-    auto input_files = args.at("<input-files>").asStringList();
+    double threshold;
+    double epsilon;
+    std::vector<std::string> input_files;
+    std::string output_prefix;
+};
 
-    ////// PROGRAM OPTIONS
+// Options communes à tous les appariements
+struct Match_options
+{
+    bool colorize;
+    bool export_all;
+    bool optimize;
+    std::optional<double> epsilon; // vaut le seuil de chaque appariement sinon
+    Weight_kernel weight_kernel;
+};
 
-    auto opt_colorize   = args.at("--colorize").asBool();
-    auto opt_export_all = args.at("--export-all").asBool();
+// Traite un appariement. Les erreurs (fichier illisible, maillage sans
+// normales, exportation impossible, ...) sont renvoyées au lieu de quitter le
+// programme pour que --batch puisse passer à l'appariement suivant.
+// 'kd_trees' ne sert qu'à cet appariement : ses arbres sont identifiés par
+// l'adresse des maillages importés pour le job, qui sont détruits à la fin.
+Status run_match(const Match_job& job, const Match_options& options,
+                 SM_kd_tree_cache& kd_trees)
+{
+    ////////// ASSIMP DATA IMPORTATION
 
-    double epsilon   = threshold;
-    auto opt_epsilon = args.at("--epsilon");
+    // Les deux premiers fichiers sont importés en même temps, puis chaque
+    // fichier est importé pendant le traitement de la paire précédente
+    auto glob_loading = prefetch_scene(job.input_files.front());
+    std::future<Result<Loaded_scene>> next_loading;
 
-    if(opt_epsilon)
-    {
-        try
-        {
-            epsilon = std::stod(opt_epsilon.asString());
-        }
-        catch(std::invalid_argument& ia)
-        {
-            std::cerr << "[ERROR] --epsilon=<dist> must be a real number\n";
-            exit(EXIT_FAILURE);
-        }
-    }
+    if(job.input_files.size() > 1)
+        next_loading = prefetch_scene(job.input_files[1]);
 
-    ////////// ASSIMP DATA IMPORTATION
+    auto glob_loaded = glob_loading.get();
 
-    auto glob_scene_data   = import_scene_data(input_files.front());
-    Surface_mesh glob_mesh = make_surface_mesh(glob_scene_data.mesh);
+    if(!glob_loaded)
+        return Error{glob_loaded.error()};
 
-    // WARNING: force mesh to be geometricaly processable by removing duplicated
-    // halfedges
-    CGAL::Polygon_mesh_processing::stitch_borders(glob_mesh);
+    auto& [glob_scene_data, glob_mesh] = *glob_loaded;
 
-    if(opt_colorize)
+    if(options.colorize)
         set_mesh_color(glob_mesh, {1.0f, 0.0f, 0.0f, 1.0f});
 
+    report_memory("import");
+
     ////////// MESH PROCESSING
 
-    for(size_t i = 1; i < input_files.size(); ++i)
+    // Les kd-trees sont conservés d'une paire à l'autre : chaque fichier est
+    // projeté sur glob_mesh, dont l'arbre n'est donc construit qu'une fois
+
+    for(size_t i = 1; i < job.input_files.size(); ++i)
     {
         ////////// ASSIMP DATA IMPORTATION
 
-        auto next_scene_data   = import_scene_data(input_files[i]);
-        Surface_mesh next_mesh = make_surface_mesh(next_scene_data.mesh);
+        auto next_loaded = next_loading.get();
+
+        if(!next_loaded)
+            return Error{next_loaded.error()};
 
-        CGAL::Polygon_mesh_processing::stitch_borders(next_mesh);
+        auto& [next_scene_data, next_mesh] = *next_loaded;
 
-        Surface_mesh curr_mesh = glob_mesh;
+        if(i + 1 < job.input_files.size())
+            next_loading = prefetch_scene(job.input_files[i + 1]);
+
+        report_memory("import");
 
         ////////// MESHES STATISTICS
 
         std::cerr << "[CURR_MESH] total vertices: "
-                  << curr_mesh.number_of_vertices() << '\n';
+                  << glob_mesh.number_of_vertices() << '\n';
 
         std::cerr << "[NEXT_MESH] total vertices: "
                   << next_mesh.number_of_vertices() << '\n';
 
         ////////// FULL COLORIZATION
 
-        if(opt_colorize)
+        if(options.colorize)
         {
             if(i == 1)
                 set_mesh_color(next_mesh, {0.0f, 1.0f, 0.0f, 1.0f});
@@ -377,28 +488,77 @@ int main(int argc, char const* argv[])
         }
 
         std::cerr << "[NEXT_MESH] Projecting...\n";
-        Surface_mesh next_proj = projection(next_mesh, curr_mesh);
+        // Seules les positions projetées sont calculées : la projection partage
+        // la connectivité de next_mesh, qui porte aussi ses annotations
+        Projected_vertices next_proj;
+
+        auto projected = try_project_points(next_mesh, glob_mesh, kd_trees,
+                                            next_proj.points, options.weight_kernel);
+
+        if(!projected)
+            return projected;
+
+        next_proj.index = Dense_vertex_index(next_mesh);
+
+        report_memory("projection");
+
+        // glob_mesh n'est plus utilisé après la dernière paire : il est alors
+        // déplacé plutôt que copié, après avoir oublié son arbre
+        Surface_mesh curr_mesh;
+
+        if(i + 1 < job.input_files.size())
+            curr_mesh = glob_mesh;
+        else
+        {
+            kd_trees.invalidate(glob_mesh);
+            curr_mesh = std::move(glob_mesh);
+        }
+
+        // Un seul calcul d'adjacence par maillage : next_mesh et sa projection
+        // ont la même connectivité et partagent la sienne
+        Vertex_adjacency curr_adjacency = make_vertex_adjacency(curr_mesh);
+        Vertex_adjacency next_adjacency = make_vertex_adjacency(next_mesh);
 
         ////////// MARKING
 
         std::cerr << "[CURR_MESH] Marking...\n";
-        mark_delimited_regions(curr_mesh, next_mesh, threshold, epsilon);
+        auto curr_marked = try_mark_delimited_regions(
+            curr_mesh, curr_adjacency, next_mesh, kd_trees, job.threshold, job.epsilon);
+
+        if(!curr_marked)
+            return Error{curr_marked.error()};
 
         std::cerr << "[NEXT_MESH_PROJECTED] Marking...\n";
-        mark_delimited_regions(next_proj, curr_mesh);
+        auto next_marked = try_mark_delimited_regions(next_mesh, next_proj,
+                                                      next_adjacency, curr_mesh);
+
+        if(!next_marked)
+            return Error{next_marked.error()};
+
+        report_memory("marking");
 
         std::cerr << "[NEXT_MESH] Partial reprojection...\n";
-        next_mesh = reproject_transition(next_mesh, next_proj); // adapte la géométrie de next pour s'adapter à curr
+        // adapte la géométrie de next pour s'adapter à curr
+        auto reprojected =
+            try_reproject_transition(next_mesh, next_proj, next_adjacency);
+
+        if(!reprojected)
+            return reprojected;
+
+        // Les points de next_mesh ont changé, et le maillage de la paire
+        // suivante peut occuper la même adresse : son arbre ne doit pas survivre
+        kd_trees.invalidate(next_mesh);
+
+        report_memory("reprojection");
 
         ////////// LIMITS COLORIZATION
 
-        if(opt_colorize)
+        if(options.colorize)
         {
             // Afficher sommets transitions/limit en jaune
+            // (ceux de la projection le sont à sa reconstruction, cf. division)
             set_mesh_color(curr_mesh, limit_vertices(curr_mesh),
                            {1.0f, 1.0f, 0.0f, 1.0f});
-            set_mesh_color(next_proj, limit_vertices(next_proj),
-                           {1.0f, 1.0f, 0.0f, 1.0f});
 
             // // Afficher sommets proche/limit en violet
             // set_mesh_color(next_proj, next_close_limit_vertices,
@@ -414,19 +574,40 @@ int main(int argc, char const* argv[])
         // Remove transition mark on curr_mesh
         mark_limits_with(curr_mesh, Vertex_mark::Distant);
         // Set limits on curr_mesh
-        mark_limits(curr_mesh);
+        auto curr_limits = try_mark_limits(curr_mesh, curr_adjacency);
 
-        auto [curr_close, curr_distant] = divide(curr_mesh);
+        if(!curr_limits)
+            return Error{curr_limits.error()};
 
-        auto [next_proj_close, next_proj_distant] =
-            divide(std::move(next_proj));
+        auto [curr_close, curr_distant] = divide(curr_mesh);
 
         std::cerr << "[NEXT_MESH] Filtering...\n";
 
-        Surface_mesh next_close =
-            filtered(next_mesh, distant_vertices(next_proj));
-        Surface_mesh next_distant =
-            filtered(next_mesh, close_vertices(next_proj));
+        // next_mesh porte les annotations de sa projection
+        auto [next_close, next_distant] = divide(next_mesh);
+
+        // Seuls les éléments intermédiaires ont besoin des parties de la
+        // projection : c'est le seul cas où elle est reconstruite en maillage
+        // (connectivité, couleurs et annotations copiées de next_mesh)
+        std::pair<Surface_mesh, Surface_mesh> next_proj_parts;
+
+        if(options.export_all)
+        {
+            Surface_mesh next_proj_mesh = next_mesh;
+
+            for(auto v : next_proj_mesh.vertices())
+                next_proj_mesh.point(v) = next_proj.point(v);
+
+            if(options.colorize)
+                set_mesh_color(next_proj_mesh, limit_vertices(next_proj_mesh),
+                               {1.0f, 1.0f, 0.0f, 1.0f});
+
+            next_proj_parts = divide(next_proj_mesh);
+        }
+
+        auto& [next_proj_close, next_proj_distant] = next_proj_parts;
+
+        report_memory("division");
 
         ////////// RECONSTRUCTION
 
@@ -447,36 +628,316 @@ int main(int argc, char const* argv[])
         std::cerr << "[STATUS] exporting...\n";
 
         // Elements permettant la reconstruction des étapes
+        std::vector<std::tuple<Scene_data*, const Surface_mesh*, std::string>>
+            exports = {
+                {&glob_scene_data, &curr_close,
+                 "M" + std::to_string(i - 1) + "_close.obj"},
+                {&glob_scene_data, &curr_distant,
+                 "M" + std::to_string(i - 1) + "_distant.obj"},
+                {&next_scene_data, &next_distant,
+                 "M" + std::to_string(i) + "_distant.obj"}};
 
-        update_scene_mesh_data(glob_scene_data, curr_close);
-        export_scene_data(glob_scene_data,
-                          "M" + std::to_string(i - 1) + "_close.obj");
+        // Elements intermediares
 
-        update_scene_mesh_data(glob_scene_data, curr_distant);
-        export_scene_data(glob_scene_data,
-                          "M" + std::to_string(i - 1) + "_distant.obj");
+        if(options.export_all)
+        {
+            exports.insert(
+                exports.end(),
+                {{&next_scene_data, &next_close,
+                  "M" + std::to_string(i) + "_close.obj"},
+                 {&next_scene_data, &next_proj_close,
+                  "M" + std::to_string(i) + "_proj_close.obj"},
+                 {&next_scene_data, &next_proj_distant,
+                  "M" + std::to_string(i) + "_proj_distant.obj"}});
+        }
 
-        update_scene_mesh_data(next_scene_data, next_distant);
-        export_scene_data(next_scene_data,
-                          "M" + std::to_string(i) + "_distant.obj");
+        for(auto& [scene_data, mesh, name] : exports)
+        {
+            update_scene_mesh_data(*scene_data, *mesh, options.optimize);
 
-        // Elements intermediares
+            auto status = export_scene_data(*scene_data, job.output_prefix + name);
+
+            if(!status)
+                return status;
+        }
+
+        report_memory("export");
+    }
+
+    return {};
+}
+
+// Bilan des caches de kd-trees de tous les appariements, affiché une seule fois
+struct Kd_tree_cache_statistics
+{
+    size_t nb_builds = 0;
+    size_t nb_reuses = 0;
 
-        if (opt_export_all)
+    void add(const SM_kd_tree_cache& kd_trees)
+    {
+        nb_builds += kd_trees.number_of_builds();
+        nb_reuses += kd_trees.number_of_reuses();
+    }
+};
+
+std::ostream& operator<<(std::ostream& os, const Kd_tree_cache_statistics& statistics)
+{
+    return os << "[STATUS] kd-tree cache : " << statistics.nb_builds
+              << " tree(s) built, " << statistics.nb_reuses
+              << " build(s) avoided\n";
+}
+
+// Lit un fichier --batch : une ligne "<threshold> <input-files>..." par
+// appariement, les lignes vides et celles qui commencent par '#' sont ignorées
+Result<std::vector<Match_job>> read_batch(const std::string& filename,
+                                          const Match_options& options)
+{
+    std::ifstream file(filename);
+
+    if(!file)
+        return Error{"cannot open batch file " + filename};
+
+    std::vector<Match_job> jobs;
+    std::string line;
+
+    for(size_t line_number = 1; std::getline(file, line); ++line_number)
+    {
+        std::istringstream words(line);
+        std::string threshold;
+
+        if(!(words >> threshold) || threshold.front() == '#')
+            continue;
+
+        Match_job job;
+
+        try
+        {
+            job.threshold = std::stod(threshold);
+        }
+        catch(std::invalid_argument& ia)
+        {
+            return Error{filename + ":" + std::to_string(line_number) +
+                         " <threshold> must be a reals numbers"};
+        }
+        catch(std::out_of_range& oor)
         {
-            update_scene_mesh_data(next_scene_data, next_close);
-            export_scene_data(next_scene_data,
-                            "M" + std::to_string(i) + "_close.obj");
+            return Error{filename + ":" + std::to_string(line_number) +
+                         " <threshold> is out of range"};
+        }
+
+        job.epsilon = options.epsilon.value_or(job.threshold);
+
+        for(std::string input_file; words >> input_file;)
+            job.input_files.push_back(input_file);
+
+        if(job.input_files.empty())
+            return Error{filename + ":" + std::to_string(line_number) +
+                         " expects at least one input file"};
+
+        job.output_prefix = "job" + std::to_string(jobs.size() + 1) + "_";
+        jobs.push_back(std::move(job));
+    }
+
+    return jobs;
+}
+
+int main(int argc, char const* argv[])
+{
+    std::map<std::string, docopt::value> args =
+        docopt::docopt(USAGE, {argv + 1, argv + argc}, true, "v1.0");
+
+    ////// PROGRAM OPTIONS
 
-            update_scene_mesh_data(next_scene_data, next_proj_close);
-            export_scene_data(next_scene_data,
-                            "M" + std::to_string(i) + "_proj_close.obj");
+    Match_options options;
 
-            update_scene_mesh_data(next_scene_data, next_proj_distant);
-            export_scene_data(next_scene_data,
-                            "M" + std::to_string(i) + "_proj_distant.obj");
+    options.colorize   = args.at("--colorize").asBool();
+    options.export_all = args.at("--export-all").asBool();
+    options.optimize   = args.at("--optimize").asBool();
+
+    auto opt_epsilon = args.at("--epsilon");
+
+    if(opt_epsilon)
+    {
+        try
+        {
+            options.epsilon = std::stod(opt_epsilon.asString());
+        }
+        catch(std::invalid_argument& ia)
+        {
+            std::cerr << "[ERROR] --epsilon=<dist> must be a real number\n";
+            exit(EXIT_FAILURE);
         }
+        catch(std::out_of_range& oor)
+        {
+            std::cerr << "[ERROR] --epsilon=<dist> is out of range\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    try
+    {
+        int nb_threads = std::stoi(args.at("--threads").asString());
+
+        if(nb_threads < 0)
+            throw std::invalid_argument("negative thread count");
+
+        set_number_of_threads(static_cast<unsigned int>(nb_threads));
+    }
+    catch(std::invalid_argument& ia)
+    {
+        std::cerr << "[ERROR] --threads=<count> must be a positive integer\n";
+        exit(EXIT_FAILURE);
+    }
+    catch(std::out_of_range& oor)
+    {
+        std::cerr << "[ERROR] --threads=<count> is out of range\n";
+        exit(EXIT_FAILURE);
+    }
+
+    std::clog << "[STATUS] using " << number_of_threads() << " thread(s)\n";
+
+    // Le noyau est choisi à l'exécution puis converti une fois par projection en noyau compilé
+    auto opt_kernel = args.at("--kernel").asString();
+
+    if(opt_kernel == "gaussian")
+        options.weight_kernel.type = Weight_kernel::Type::Gaussian;
+    else if(opt_kernel == "wendland")
+        options.weight_kernel.type = Weight_kernel::Type::Wendland;
+    else if(opt_kernel == "singular")
+        options.weight_kernel.type = Weight_kernel::Type::Singular;
+    else if(opt_kernel == "uniform")
+        options.weight_kernel.type = Weight_kernel::Type::Uniform;
+    else
+    {
+        std::cerr << "[ERROR] --kernel=<type> must be gaussian, wendland, singular or uniform\n";
+        exit(EXIT_FAILURE);
+    }
+
+    // Chaque combinaison type / mode de rayon a son noyau compilé (cf. dispatch_weight_kernel)
+    auto opt_radius_mode = args.at("--radius-mode").asString();
+
+    if(opt_radius_mode == "adaptive")
+        options.weight_kernel.radius_mode = Weight_kernel::Mode::Adaptive;
+    else if(opt_radius_mode == "max")
+        options.weight_kernel.radius_mode = Weight_kernel::Mode::Max;
+    else if(opt_radius_mode == "constant")
+        options.weight_kernel.radius_mode = Weight_kernel::Mode::Constant;
+    else
+    {
+        std::cerr << "[ERROR] --radius-mode=<mode> must be adaptive, max or constant\n";
+        exit(EXIT_FAILURE);
+    }
+
+    try
+    {
+        options.weight_kernel.s_exponent = std::stod(args.at("--singular-exponent").asString());
+        options.weight_kernel.radius     = std::stod(args.at("--radius").asString());
+    }
+    catch(std::invalid_argument& ia)
+    {
+        std::cerr << "[ERROR] --singular-exponent=<exp> and --radius=<dist> must be real numbers\n";
+        exit(EXIT_FAILURE);
+    }
+    catch(std::out_of_range& oor)
+    {
+        std::cerr << "[ERROR] --singular-exponent=<exp> or --radius=<dist> is out of range\n";
+        exit(EXIT_FAILURE);
+    }
+
+    if(!std::isfinite(options.weight_kernel.s_exponent) || options.weight_kernel.s_exponent < 0)
+    {
+        std::cerr << "[ERROR] --singular-exponent=<exp> must be a positive real number\n";
+        exit(EXIT_FAILURE);
+    }
+
+    if(!std::isfinite(options.weight_kernel.radius) || options.weight_kernel.radius < 0 ||
+       (options.weight_kernel.radius_mode == Weight_kernel::Mode::Constant &&
+        options.weight_kernel.radius == 0))
+    {
+        std::cerr << "[ERROR] --radius=<dist> must be a positive real number (non zero in "
+                     "constant mode)\n";
+        exit(EXIT_FAILURE);
+    }
+
+    ////// BATCH PROCESSING
+
+    auto opt_batch = args.at("--batch");
+
+    if(opt_batch)
+    {
+        auto jobs = read_batch(opt_batch.asString(), options);
+
+        if(!jobs)
+        {
+            std::cerr << "[ERROR] " << jobs.error() << '\n';
+            exit(EXIT_FAILURE);
+        }
+
+        size_t nb_failures = 0;
+        Kd_tree_cache_statistics kd_tree_statistics;
+
+        for(size_t j = 0; j < jobs->size(); ++j)
+        {
+            std::clog << "[STATUS] job " << j + 1 << '/' << jobs->size() << '\n';
+
+            // Un cache par job : les maillages (et donc les arbres) ne sont pas
+            // partagés entre les jobs
+            SM_kd_tree_cache kd_trees;
+
+            auto status = run_match((*jobs)[j], options, kd_trees);
+
+            kd_tree_statistics.add(kd_trees);
+
+            if(!status)
+            {
+                std::cerr << "[ERROR] job " << j + 1 << " : " << status.error()
+                          << '\n';
+                ++nb_failures;
+            }
+        }
+
+        std::clog << kd_tree_statistics;
+        std::clog << "[STATUS] " << jobs->size() - nb_failures << '/'
+                  << jobs->size() << " job(s) succeeded\n";
+
+        return nb_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    ////// PROGRAM ARGUMENTS
+
+    Match_job job;
+
+    try
+    {
+        job.threshold = std::stod(args.at("<threshold>").asString());
+    }
+    catch(std::invalid_argument& ia)
+    {
+        std::cerr << "[ERROR] <threshold> must be a reals numbers\n";
+        exit(EXIT_FAILURE);
+    }
+    catch(std::out_of_range& oor)
+    {
+        std::cerr << "[ERROR] <threshold> is out of range\n";
+        exit(EXIT_FAILURE);
+    }
+
+    job.epsilon     = options.epsilon.value_or(job.threshold);
+    job.input_files = args.at("<input-files>").asStringList();
+
+    SM_kd_tree_cache kd_trees;
+
+    auto status = run_match(job, options, kd_trees);
+
+    Kd_tree_cache_statistics kd_tree_statistics;
+    kd_tree_statistics.add(kd_trees);
+    std::clog << kd_tree_statistics;
+
+    if(!status)
+    {
+        std::cerr << "[ERROR] " << status.error() << '\n';
+        exit(EXIT_FAILURE);
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
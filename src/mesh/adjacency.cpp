@@ -0,0 +1,58 @@
+#include "adjacency.hpp"
+
+// PROJECT
+
+#include "indexing.hpp"
+#include "parallel.hpp"
+
+// CGAL
+
+#include <CGAL/boost/graph/iterator.h>
+
+size_t Vertex_adjacency::size() const
+{
+	return vertices.size();
+}
+
+Vertex_adjacency make_vertex_adjacency(const Surface_mesh& mesh)
+{
+	Vertex_adjacency adjacency;
+
+	adjacency.vertices.assign(mesh.vertices().begin(), mesh.vertices().end());
+
+	size_t nb_vertices = adjacency.vertices.size();
+
+	// Degrés, rangés en i + 1 pour être cumulés sur place (les sommets isolés n'ont pas de voisins)
+	adjacency.offsets.resize(nb_vertices + 1);
+	adjacency.offsets[0] = 0;
+
+	parallel_for(nb_vertices, [&](size_t i) {
+		auto v = adjacency.vertices[i];
+
+		adjacency.offsets[i + 1] = mesh.halfedge(v) == Surface_mesh::null_halfedge()
+									   ? 0
+									   : static_cast<unsigned int>(mesh.degree(v));
+	});
+
+	for(size_t i = 0; i < nb_vertices; ++i)
+		adjacency.offsets[i + 1] += adjacency.offsets[i];
+
+	adjacency.neighbors.resize(adjacency.offsets.back());
+
+	// Index dense de chaque sommet (les sommets effacés n'en ont pas)
+	Dense_vertex_index dense_index(mesh);
+
+	parallel_for(nb_vertices, [&](size_t i) {
+		auto v = adjacency.vertices[i];
+
+		if(mesh.halfedge(v) == Surface_mesh::null_halfedge())
+			return;
+
+		unsigned int n = adjacency.offsets[i];
+
+		for(auto neighbor : CGAL::vertices_around_target(mesh.halfedge(v), mesh))
+			adjacency.neighbors[n++] = dense_index[neighbor];
+	});
+
+	return adjacency;
+}
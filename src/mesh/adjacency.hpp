@@ -0,0 +1,32 @@
+#ifndef MESH_ADJACENCY_HPP
+#define MESH_ADJACENCY_HPP
+
+// PROJECT
+
+#include "../instance/Surface_mesh.hpp"
+
+// STD
+
+#include <vector>
+
+// Adjacence des sommets d'une Surface_mesh au format CSR, construite une fois puis partagée par
+// les parcours de voisinage (annotation des limites, sélection de sommets). Les sommets sont
+// numérotés de façon dense (cf. Dense_vertex_index) : le sommet i est 'vertices[i]' et ses voisins
+// sont neighbors[offsets[i]] ... neighbors[offsets[i + 1] - 1].
+//
+// L'adjacence ne dépend que de la connectivité : elle reste valide pour une copie du maillage dont
+// seules les positions ou les propriétés ont changé (ex: un maillage et sa projection).
+struct Vertex_adjacency
+{
+	std::vector<Surface_mesh::Vertex_index> vertices;
+	std::vector<unsigned int> offsets;
+	std::vector<unsigned int> neighbors;
+
+	size_t size() const;
+};
+
+// Construit l'adjacence en parallèle : les degrés sont comptés, cumulés, puis chaque thread écrit
+// les voisins de ses sommets à leur place (le résultat ne dépend pas du nombre de threads).
+Vertex_adjacency make_vertex_adjacency(const Surface_mesh& mesh);
+
+#endif // MESH_ADJACENCY_HPP
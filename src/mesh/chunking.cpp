@@ -0,0 +1,209 @@
+#include "chunking.hpp"
+
+// PROJECT
+
+#include "parallel.hpp"
+
+// STD
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace
+{
+
+// Intercale des zéros entre les 10 bits de poids faible de 'x' (x -> x0 0 x1 0 0 x2 ...)
+std::uint32_t spread_bits(std::uint32_t x)
+{
+	x &= 0x3FFu;
+	x = (x | (x << 16)) & 0x030000FFu;
+	x = (x | (x << 8)) & 0x0300F00Fu;
+	x = (x | (x << 4)) & 0x030C30C3u;
+	x = (x | (x << 2)) & 0x09249249u;
+	return x;
+}
+
+// Code de Morton (3 x 10 bits) d'un point dans le cube [min, min + extent]
+std::uint32_t morton_code(const Mesh_data::vec_3f& point, const Mesh_data::vec_3f& min,
+						  float extent)
+{
+	std::uint32_t code = 0;
+
+	for(size_t c = 0; c < 3; ++c)
+	{
+		float t = extent > 0 ? (point[c] - min[c]) / extent : 0.0f;
+		auto q	= static_cast<std::uint32_t>(std::clamp(t, 0.0f, 1.0f) * 1023.0f);
+		code |= spread_bits(q) << c;
+	}
+
+	return code;
+}
+
+template <class Attribute>
+void copy_chunk_attribute(const std::optional<std::vector<Attribute>>& source,
+						  std::optional<std::vector<Attribute>>& destination,
+						  const std::vector<unsigned int>& vertices)
+{
+	if(!source)
+		return;
+
+	auto& values = destination.emplace(vertices.size());
+
+	for(size_t i = 0; i < vertices.size(); ++i)
+		values[i] = (*source)[vertices[i]];
+}
+
+} // namespace
+
+Chunked_mesh_data make_chunked_mesh_data(const Mesh_data& mesh_data, size_t max_vertices)
+{
+	const auto& positions = *mesh_data.positions;
+	const auto& faces	  = *mesh_data.triangulated_faces;
+
+	Chunked_mesh_data chunked;
+
+	// Boite englobante du maillage (pour quantifier les centres des triangles)
+	const float max_float = std::numeric_limits<float>::max();
+
+	Mesh_data::vec_3f min = {max_float, max_float, max_float};
+	Mesh_data::vec_3f max = {-max_float, -max_float, -max_float};
+
+	for(const auto& position : positions)
+	{
+		for(size_t c = 0; c < 3; ++c)
+		{
+			min[c] = std::min(min[c], position[c]);
+			max[c] = std::max(max[c], position[c]);
+		}
+	}
+
+	// Même pas de quantification sur les trois axes : une couche de scan très fine selon un axe
+	// serait sinon découpée en tranches selon cet axe
+	float extent = std::max({max[0] - min[0], max[1] - min[1], max[2] - min[2]});
+
+	// Tri des triangles par code de Morton de leur centre
+	std::vector<std::pair<std::uint32_t, unsigned int>> order(faces.size());
+
+	parallel_for(faces.size(), [&](size_t f) {
+		Mesh_data::vec_3f center = {0, 0, 0};
+
+		for(auto v : faces[f])
+		{
+			for(size_t c = 0; c < 3; ++c)
+				center[c] += positions[v][c] / 3.0f;
+		}
+
+		order[f] = {morton_code(center, min, extent), static_cast<unsigned int>(f)};
+	});
+
+	std::sort(order.begin(), order.end());
+
+	// Regroupement dans l'ordre de Morton : un nouveau morceau commence quand les sommets du
+	// triangle courant ne tiennent plus dans le morceau courant. Seuls les sommets des faces sont
+	// répartis : un sommet isolé n'appartient à aucun morceau et disparaît du résultat.
+	const unsigned int none = std::numeric_limits<unsigned int>::max();
+
+	std::vector<unsigned int> vertex_chunk(positions.size(), none); // dernier morceau du sommet
+	std::vector<unsigned int> face_chunk(faces.size());
+
+	unsigned int nb_chunks = 0;
+	size_t chunk_vertices  = 0;
+
+	for(const auto& [code, f] : order)
+	{
+		unsigned int chunk_number = nb_chunks - 1;
+		size_t new_vertices		  = 0;
+
+		for(auto v : faces[f])
+			new_vertices += (nb_chunks == 0 || vertex_chunk[v] != chunk_number) ? std::size_t{1}
+																				   : std::size_t{0};
+
+		if(nb_chunks == 0 || chunk_vertices + new_vertices > max_vertices)
+		{
+			chunk_number   = nb_chunks++;
+			chunk_vertices = 0;
+		}
+
+		for(auto v : faces[f])
+		{
+			if(vertex_chunk[v] != chunk_number)
+			{
+				vertex_chunk[v] = chunk_number;
+				++chunk_vertices;
+			}
+		}
+
+		face_chunk[f] = chunk_number;
+	}
+
+	// Dans chaque morceau, les triangles gardent leur ordre d'origine (cf. optimization.hpp) et
+	// les sommets sont numérotés dans l'ordre de leur première utilisation
+	std::vector<size_t> chunk_offsets(nb_chunks + 1, 0);
+
+	for(auto chunk_number : face_chunk)
+		++chunk_offsets[chunk_number + 1];
+
+	for(size_t c = 0; c < nb_chunks; ++c)
+		chunk_offsets[c + 1] += chunk_offsets[c];
+
+	std::vector<unsigned int> chunk_faces(faces.size());
+
+	{
+		std::vector<size_t> next = chunk_offsets;
+
+		for(size_t f = 0; f < faces.size(); ++f)
+			chunk_faces[next[face_chunk[f]]++] = static_cast<unsigned int>(f);
+	}
+
+	std::fill(vertex_chunk.begin(), vertex_chunk.end(), none);
+	std::vector<unsigned int> local_index(positions.size()); // index dans le dernier morceau
+
+	std::vector<unsigned int> vertices; // sommets de tous les morceaux (index globaux)
+
+	chunked.chunks.resize(nb_chunks);
+	chunked.indices.reserve(3 * faces.size());
+
+	for(unsigned int c = 0; c < nb_chunks; ++c)
+	{
+		Mesh_chunk& chunk  = chunked.chunks[c];
+		chunk.first_vertex = vertices.size();
+		chunk.first_index  = chunked.indices.size();
+		chunk.min		   = {max_float, max_float, max_float};
+		chunk.max		   = {-max_float, -max_float, -max_float};
+
+		for(size_t i = chunk_offsets[c]; i < chunk_offsets[c + 1]; ++i)
+		{
+			for(auto v : faces[chunk_faces[i]])
+			{
+				if(vertex_chunk[v] != c)
+				{
+					vertex_chunk[v] = c;
+					local_index[v]	= static_cast<unsigned int>(vertices.size() - chunk.first_vertex);
+					vertices.push_back(v);
+
+					for(size_t k = 0; k < 3; ++k)
+					{
+						chunk.min[k] = std::min(chunk.min[k], positions[v][k]);
+						chunk.max[k] = std::max(chunk.max[k], positions[v][k]);
+					}
+				}
+
+				chunked.indices.push_back(static_cast<std::uint16_t>(local_index[v]));
+			}
+		}
+
+		chunk.number_of_vertices = vertices.size() - chunk.first_vertex;
+		chunk.number_of_indices	 = chunked.indices.size() - chunk.first_index;
+	}
+
+	// Attributs des sommets dans l'ordre des morceaux
+	copy_chunk_attribute(mesh_data.positions, chunked.data.positions, vertices);
+	copy_chunk_attribute(mesh_data.normals, chunked.data.normals, vertices);
+	copy_chunk_attribute(mesh_data.colors, chunked.data.colors, vertices);
+	copy_chunk_attribute(mesh_data.texcoords, chunked.data.texcoords, vertices);
+
+	chunked.data.texture_path = mesh_data.texture_path;
+
+	return chunked;
+}
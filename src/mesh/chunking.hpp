@@ -0,0 +1,49 @@
+#ifndef MESH_CHUNKING_HPP
+#define MESH_CHUNKING_HPP
+
+// PROJECT
+
+#include "data.hpp"
+
+// STD
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Morceau d'un maillage découpé par make_chunked_mesh_data : ses sommets sont contigus dans les
+// tableaux de sommets et ses index (sur 16 bits) sont relatifs à son premier sommet.
+struct Mesh_chunk
+{
+	size_t first_vertex		  = 0;
+	size_t number_of_vertices = 0;
+	size_t first_index		  = 0;
+	size_t number_of_indices  = 0;
+
+	// Boite englobante des sommets du morceau
+	Mesh_data::vec_3f min;
+	Mesh_data::vec_3f max;
+};
+
+struct Chunked_mesh_data
+{
+	// Sommets regroupés par morceaux (les sommets partagés par plusieurs morceaux sont dupliqués),
+	// 'triangulated_faces' n'est pas défini : les faces sont dans 'indices'
+	Mesh_data data;
+
+	std::vector<std::uint16_t> indices;
+	std::vector<Mesh_chunk> chunks;
+};
+
+// Découpe les triangles de 'mesh_data' en morceaux spatialement cohérents d'au plus
+// 'max_vertices' sommets (65535 pour des index GL_UNSIGNED_SHORT) : les triangles sont triés
+// selon le code de Morton de leur centre puis regroupés dans cet ordre. Dans un morceau, les
+// triangles gardent leur ordre dans 'mesh_data' (pour conserver l'ordre optimisé par
+// optimize_mesh_data). Les morceaux servent d'unités d'affichage (élimination hors champ, mises à
+// jour partielles).
+// Les sommets qui n'appartiennent à aucune face ne sont pas conservés.
+// Précondition : mesh_data a des positions et des faces, max_vertices >= 3.
+Chunked_mesh_data make_chunked_mesh_data(const Mesh_data& mesh_data,
+										 size_t max_vertices = 65535);
+
+#endif // MESH_CHUNKING_HPP
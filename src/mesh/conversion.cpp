@@ -3,11 +3,23 @@
 
 #include "conversion.hpp"
 
+// PROJECT
+
+#include "indexing.hpp"
+#include "parallel.hpp"
+
 // CGAL
 
 #include <CGAL/IO/Color.h>
+#include <CGAL/boost/graph/helpers.h>
 #include <CGAL/boost/graph/iterator.h>
 
+// STD
+
+#include <cstring>
+#include <iostream>
+#include <tuple>
+
 Surface_mesh to_surface_mesh(const Mesh_data& mesh_data)
 {
 	using Vertex_index = Surface_mesh::Vertex_index;
@@ -19,6 +31,18 @@ Surface_mesh to_surface_mesh(const Mesh_data& mesh_data)
 
 	Surface_mesh mesh;
 
+	// Préallocation : d'après la formule d'Euler, un maillage triangulé a environ autant d'arêtes
+	// que de sommets et de faces réunis
+	{
+		size_type nb_vertices =
+			mesh_data.positions.has_value() ? static_cast<size_type>(mesh_data.positions->size()) : 0;
+		size_type nb_faces = mesh_data.triangulated_faces.has_value()
+								 ? static_cast<size_type>(mesh_data.triangulated_faces->size())
+								 : 0;
+
+		mesh.reserve(nb_vertices, nb_vertices + nb_faces, nb_faces);
+	}
+
 	if(mesh_data.positions.has_value())
 	{
 		for(size_t i = 0; i < mesh_data.positions->size(); ++i)
@@ -104,165 +128,214 @@ Surface_mesh to_surface_mesh(const Mesh_data& mesh_data)
 	return mesh;
 }
 
-Mesh_data to_mesh_data(const Surface_mesh& mesh,
-					   const std::string& texture_path)
+namespace
+{
+
+// Cartes des attributs de sommets, cherchées une seule fois par conversion
+struct Vertex_attribute_maps
 {
 	using Vertex_index = Surface_mesh::Vertex_index;
-	using size_type	   = Surface_mesh::size_type;
 
-	using Vector_3 = Kernel::Vector_3;
-	using Vector_2 = Kernel::Vector_2;
-	using Color	   = std::array<float, 4>;
+	Surface_mesh::Property_map<Vertex_index, Kernel::Vector_3> normals;
+	Surface_mesh::Property_map<Vertex_index, std::array<float, 4>> colors;
+	Surface_mesh::Property_map<Vertex_index, Kernel::Vector_2> texcoords;
 
-	if(mesh.number_of_vertices() == 0)
+	bool has_normals   = false;
+	bool has_colors	   = false;
+	bool has_texcoords = false;
+
+	explicit Vertex_attribute_maps(const Surface_mesh& mesh)
 	{
-		std::cerr << "[WARNING] to_mesh_data : contains no vertices\n";
-		return Mesh_data{};
+		std::tie(normals, has_normals) =
+			mesh.template property_map<Vertex_index, Kernel::Vector_3>("v:normal");
+		std::tie(colors, has_colors) =
+			mesh.template property_map<Vertex_index, std::array<float, 4>>("v:color");
+		std::tie(texcoords, has_texcoords) =
+			mesh.template property_map<Vertex_index, Kernel::Vector_2>("v:texcoord");
 	}
+};
 
-	std::map<Vertex_index, unsigned int> indice_map;
-
-	std::optional<std::vector<Mesh_data::vec_3f>> positions;
+// Appelle 'function(i, v)' pour chaque sommet v d'index dense i, en parallèle. Sans sommet effacé
+// le sommet d'index dense i est Vertex_index(i), sinon les sommets sont d'abord listés.
+template <class Function>
+void for_each_dense_vertex(const Surface_mesh& mesh, Function&& function)
+{
+	using Vertex_index = Surface_mesh::Vertex_index;
 
-	// point map exist by default on surface_mesh
+	if(mesh.number_of_removed_vertices() == 0)
 	{
-		size_type i = 0;
+		parallel_for(mesh.number_of_vertices(),
+					 [&](size_t i) { function(i, static_cast<Vertex_index>(i)); });
+	}
+	else
+	{
+		std::vector<Vertex_index> vertices(mesh.vertices().begin(), mesh.vertices().end());
+		parallel_for(vertices.size(), [&](size_t i) { function(i, vertices[i]); });
+	}
+}
+
+template <size_t N, class Vector>
+void write_floats(const Vector& vector, float* destination)
+{
+	for(size_t c = 0; c < N; ++c)
+		destination[c] = static_cast<float>(vector[static_cast<int>(c)]);
+}
 
-		positions.emplace(
-			std::vector<Mesh_data::vec_3f>(mesh.number_of_vertices()));
+} // namespace
 
-		for(auto v : mesh.vertices())
-		{
-			auto position	= mesh.point(v);
-			(*positions)[i] = {static_cast<float>(position[0]),
-							   static_cast<float>(position[1]),
-							   static_cast<float>(position[2])};
-			indice_map[v]	= i;
-			++i;
-			// 	std::cerr << vertices[i].x << ", " << vertices[i].y << ", " <<
-			// vertices[i].z <<
-			// '\n';
-		}
-	}
+Interleaved_layout interleaved_layout(const Surface_mesh& mesh)
+{
+	Vertex_attribute_maps maps(mesh);
+	Interleaved_layout layout;
 
-	std::optional<std::vector<Mesh_data::vec_3f>> normals;
+	auto append = [&layout](int& offset, size_t nb_floats) {
+		offset = static_cast<int>(layout.stride);
+		layout.stride += nb_floats * sizeof(float);
+	};
 
-	auto [normal_map, normal_map_exist] =
-		mesh.template property_map<Vertex_index, Vector_3>("v:normal");
+	append(layout.position, 3);
 
-	if(normal_map_exist)
-	{
-		size_type i = 0;
+	if(maps.has_normals)
+		append(layout.normal, 3);
 
-		normals.emplace(
-			std::vector<Mesh_data::vec_3f>(mesh.number_of_vertices()));
+	if(maps.has_colors)
+		append(layout.color, 4);
 
-		for(auto v : mesh.vertices())
+	if(maps.has_texcoords)
+		append(layout.texcoord, 2);
+
+	return layout;
+}
+
+void write_interleaved_vertices(const Surface_mesh& mesh, const Interleaved_layout& layout,
+								char* destination)
+{
+	Vertex_attribute_maps maps(mesh);
+
+	for_each_dense_vertex(mesh, [&](size_t i, Surface_mesh::Vertex_index v) {
+		char* vertex = destination + i * layout.stride;
+
+		// 'destination' est un tampon d'octets : les valeurs y sont recopiées par memcpy
+		float values[3];
+
+		write_floats<3>(mesh.point(v), values);
+		std::memcpy(vertex + layout.position, values, 3 * sizeof(float));
+
+		if(maps.has_normals && layout.normal >= 0)
 		{
-			auto normal	  = normal_map[v];
-			(*normals)[i] = {static_cast<float>(normal[0]),
-							 static_cast<float>(normal[1]),
-							 static_cast<float>(normal[2])};
-			++i;
+			write_floats<3>(maps.normals[v], values);
+			std::memcpy(vertex + layout.normal, values, 3 * sizeof(float));
 		}
-	}
-	else
-	{
-		std::clog << "[STATUS] to_mesh_data : no normal map found\n";
-	}
 
-	std::optional<std::vector<Mesh_data::vec_4f>> colors;
+		if(maps.has_colors && layout.color >= 0)
+			std::memcpy(vertex + layout.color, maps.colors[v].data(), 4 * sizeof(float));
+
+		if(maps.has_texcoords && layout.texcoord >= 0)
+		{
+			write_floats<2>(maps.texcoords[v], values);
+			std::memcpy(vertex + layout.texcoord, values, 2 * sizeof(float));
+		}
+	});
+}
+
+size_t write_triangles(const Surface_mesh& mesh, unsigned int* destination)
+{
+	using Face_index = Surface_mesh::Face_index;
+
+	Dense_vertex_index dense_index(mesh);
 
-	auto [color_map, color_map_exist] =
-		mesh.template property_map<Vertex_index, Color>("v:color");
+	auto write_triangle = [&](Face_index face, unsigned int* triangle) {
+		auto h = mesh.halfedge(face);
 
-	if(color_map_exist)
+		// Même ordre que CGAL::vertices_around_face(h)
+		triangle[0] = dense_index[mesh.target(h)];
+		triangle[1] = dense_index[mesh.target(mesh.next(h))];
+		triangle[2] = dense_index[mesh.source(h)];
+	};
+
+	// Cas courant : toutes les faces sont des triangles et aucune n'est effacée, la face i est
+	// écrite à la position i sans synchronisation
+	if(mesh.number_of_removed_faces() == 0 && CGAL::is_triangle_mesh(mesh))
 	{
-		size_type i = 0;
+		parallel_for(mesh.number_of_faces(), [&](size_t f) {
+			write_triangle(static_cast<Face_index>(f), destination + 3 * f);
+		});
+
+		return mesh.number_of_faces();
+	}
 
-		colors.emplace(
-			std::vector<Mesh_data::vec_4f>(mesh.number_of_vertices()));
+	size_t f = 0;
 
-		for(auto v : mesh.vertices())
+	for(auto face : mesh.faces())
+	{
+		if(mesh.degree(face) != 3)
 		{
-			auto color	 = color_map[v];
-			(*colors)[i] = {color[0], color[1], color[2], color[3]};
-			++i;
+			std::cerr << "[WARNING] to_mesh_data : skipped face " << face
+					  << " that is not a triangle\n";
+			continue;
 		}
+
+		write_triangle(face, destination + 3 * f);
+		++f;
 	}
-	else
+
+	return f;
+}
+
+Mesh_data to_mesh_data(const Surface_mesh& mesh,
+					   const std::string& texture_path)
+{
+	if(mesh.number_of_vertices() == 0)
 	{
-		std::clog << "[STATUS] to_mesh_data : no color map found\n";
+		std::cerr << "[WARNING] to_mesh_data : contains no vertices\n";
+		return Mesh_data{};
 	}
 
-	std::optional<std::vector<Mesh_data::vec_2f>> texcoords;
+	Vertex_attribute_maps maps(mesh);
+	Mesh_data mesh_data;
 
-	auto [texcoord_map, texcoord_map_exist] =
-		mesh.template property_map<Vertex_index, Vector_2>("v:texcoord");
+	size_t nb_vertices = mesh.number_of_vertices();
 
-	if(texcoord_map_exist)
-	{
-		size_type i = 0;
+	auto& positions = mesh_data.positions.emplace(nb_vertices);
 
-		texcoords.emplace(
-			std::vector<Mesh_data::vec_2f>(mesh.number_of_vertices()));
+	if(maps.has_normals)
+		mesh_data.normals.emplace(nb_vertices);
+	else
+		std::clog << "[STATUS] to_mesh_data : no normal map found\n";
 
-		for(auto v : mesh.vertices())
-		{
-			auto texcoord	= texcoord_map[v];
-			(*texcoords)[i] = {static_cast<float>(texcoord[0]),
-							   static_cast<float>(texcoord[1])};
-			++i;
-		}
-	}
+	if(maps.has_colors)
+		mesh_data.colors.emplace(nb_vertices);
 	else
-	{
-		std::clog << "[STATUS] to_mesh_data : no texcoord map found\n";
-	}
+		std::clog << "[STATUS] to_mesh_data : no color map found\n";
 
-	std::optional<std::vector<Mesh_data::vec_3u>> triangulated_faces;
+	if(maps.has_texcoords)
+		mesh_data.texcoords.emplace(nb_vertices);
+	else
+		std::clog << "[STATUS] to_mesh_data : no texcoord map found\n";
 
-	// face map exist by default on surface_mesh
-	{
-		size_type f = 0;
+	// Un seul parcours des sommets pour tous les attributs
+	for_each_dense_vertex(mesh, [&](size_t i, Surface_mesh::Vertex_index v) {
+		write_floats<3>(mesh.point(v), positions[i].data());
 
-		triangulated_faces.emplace(
-			std::vector<Mesh_data::vec_3u>(mesh.number_of_faces()));
+		if(maps.has_normals)
+			write_floats<3>(maps.normals[v], (*mesh_data.normals)[i].data());
 
-		for(auto face : mesh.faces())
-		{
-			auto face_vertices =
-				CGAL::vertices_around_face(mesh.halfedge(face), mesh);
+		if(maps.has_colors)
+			(*mesh_data.colors)[i] = maps.colors[v];
 
-			if(face_vertices.size() != 3)
-			{
-				std::cerr << "[WARNING] to_mesh_data : skipped face " << face
-						  << " that is not a triangle\n";
-				continue;
-			}
+		if(maps.has_texcoords)
+			write_floats<2>(maps.texcoords[v], (*mesh_data.texcoords)[i].data());
+	});
 
-			size_type i = 0;
+	auto& triangulated_faces = mesh_data.triangulated_faces.emplace(mesh.number_of_faces());
 
-			for(auto v : face_vertices)
-			{
-				(*triangulated_faces)[f][i] = indice_map[v];
-				++i;
-			}
+	if(!triangulated_faces.empty())
+		triangulated_faces.resize(write_triangles(mesh, triangulated_faces.front().data()));
 
-			++f;
-		}
-	}
+	if(!texture_path.empty())
+		mesh_data.texture_path = texture_path;
 
-	if(texture_path.empty())
-	{
-		return Mesh_data{positions,			 normals, colors, texcoords,
-						 triangulated_faces, {}};
-	}
-	else
-	{
-		return Mesh_data{positions,			 normals,	  colors, texcoords,
-						 triangulated_faces, texture_path};
-	}
+	return mesh_data;
 }
 
 Mesh_data to_mesh_data(const Surface_mesh& mesh)
@@ -19,6 +19,30 @@ Mesh_data to_mesh_data(const Surface_mesh& mesh,
 
 Mesh_data to_mesh_data(const Surface_mesh& mesh);
 
+// Disposition d'un sommet dans un tampon entrelacé : décalages en octets dans le sommet, -1 si
+// l'attribut est absent. Tous les attributs sont des float (position 3, normale 3, couleur 4,
+// coordonnée de texture 2).
+struct Interleaved_layout
+{
+	size_t stride = 0;
+	int position  = -1;
+	int normal	  = -1;
+	int color	  = -1;
+	int texcoord  = -1;
+};
+
+// Disposition compacte des attributs présents sur le maillage ('v:normal', 'v:color', 'v:texcoord')
+Interleaved_layout interleaved_layout(const Surface_mesh& mesh);
+
+// Écrit les sommets dans l'ordre dense (cf. indexing.hpp) dans 'destination', qui doit pouvoir
+// contenir number_of_vertices() * layout.stride octets (ex: buffer OpenGL projeté, cf. QGLMesh).
+void write_interleaved_vertices(const Surface_mesh& mesh, const Interleaved_layout& layout,
+								char* destination);
+
+// Écrit 3 index denses par triangle dans 'destination' (3 * number_of_faces() entiers au plus) et
+// renvoie le nombre de triangles écrits, les faces qui ne sont pas des triangles sont ignorées.
+size_t write_triangles(const Surface_mesh& mesh, unsigned int* destination);
+
 // #include "conversion.inl"
 
 #endif // MESH_CONVERT_HPP
\ No newline at end of file
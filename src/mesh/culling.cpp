@@ -0,0 +1,71 @@
+#include "culling.hpp"
+
+// STD
+
+#include <cmath>
+
+Frustum make_frustum(const float* mvp_matrix)
+{
+	// Méthode de Gribb et Hartmann : les plans sont des combinaisons des lignes de la matrice
+	auto row = [mvp_matrix](size_t i) {
+		return std::array<float, 4>{mvp_matrix[i], mvp_matrix[4 + i], mvp_matrix[8 + i],
+									mvp_matrix[12 + i]};
+	};
+
+	const auto w = row(3);
+
+	Frustum frustum;
+
+	for(size_t axis = 0; axis < 3; ++axis)
+	{
+		const auto r = row(axis);
+
+		for(size_t c = 0; c < 4; ++c)
+		{
+			frustum.planes[2 * axis][c]		= w[c] + r[c];
+			frustum.planes[2 * axis + 1][c] = w[c] - r[c];
+		}
+	}
+
+	// Normalisation (utile seulement pour interpréter d comme une distance)
+	for(auto& plane : frustum.planes)
+	{
+		float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+
+		if(length > 0.0f)
+		{
+			for(auto& coefficient : plane)
+				coefficient /= length;
+		}
+	}
+
+	return frustum;
+}
+
+bool intersects(const Frustum& frustum, const Mesh_data::vec_3f& min,
+				const Mesh_data::vec_3f& max)
+{
+	for(const auto& plane : frustum.planes)
+	{
+		// Sommet de la boite le plus loin dans la direction de la normale du plan
+		float distance = plane[3];
+
+		for(size_t c = 0; c < 3; ++c)
+			distance += plane[c] * (plane[c] >= 0.0f ? max[c] : min[c]);
+
+		if(distance < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+Culling_statistics& Culling_statistics::operator+=(const Culling_statistics& other)
+{
+	drawn_triangles += other.drawn_triangles;
+	culled_triangles += other.culled_triangles;
+	drawn_chunks += other.drawn_chunks;
+	culled_chunks += other.culled_chunks;
+
+	return *this;
+}
@@ -0,0 +1,42 @@
+#ifndef MESH_CULLING_HPP
+#define MESH_CULLING_HPP
+
+// PROJECT
+
+#include "data.hpp"
+
+// STD
+
+#include <array>
+#include <cstddef>
+
+// Pyramide de vue de la caméra, décrite par ses 6 plans (gauche, droite, bas, haut, proche,
+// lointain). Chaque plan (a, b, c, d) est orienté vers l'intérieur : un point (x, y, z) est du
+// bon côté si a * x + b * y + c * z + d >= 0.
+struct Frustum
+{
+	std::array<std::array<float, 4>, 6> planes;
+};
+
+// Extrait les plans d'une matrice modèle-vue-projection OpenGL (16 flottants rangés par colonnes,
+// cf. Camera::getModelViewProjectionMatrix) : les plans sont exprimés dans le repère du modèle.
+Frustum make_frustum(const float* mvp_matrix);
+
+// Faux si la boite englobante (min, max) est entièrement à l'extérieur d'un des plans. Le test
+// est conservatif : une boite proche d'un coin de la pyramide peut être gardée à tort.
+bool intersects(const Frustum& frustum, const Mesh_data::vec_3f& min,
+				const Mesh_data::vec_3f& max);
+
+// Nombre de triangles envoyés au GPU et éliminés par le test de visibilité lors d'un affichage
+struct Culling_statistics
+{
+	size_t drawn_triangles	= 0;
+	size_t culled_triangles = 0;
+
+	size_t drawn_chunks	 = 0;
+	size_t culled_chunks = 0;
+
+	Culling_statistics& operator+=(const Culling_statistics& other);
+};
+
+#endif // MESH_CULLING_HPP
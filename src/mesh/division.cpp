@@ -0,0 +1,192 @@
+#include "division.hpp"
+
+// PROJECT
+
+#include "flat.hpp"
+
+// CGAL
+
+#include <CGAL/boost/graph/iterator.h>
+
+// STD
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+using Vertex_index = Surface_mesh::Vertex_index;
+
+// Recopie l'attribut 'name' des sommets de 'mesh' dans 'part' s'il existe
+template <class T>
+void copy_vertex_property(const Surface_mesh& mesh, Surface_mesh& part,
+						  const std::vector<Vertex_index>& part_vertices, const std::string& name)
+{
+	auto [source, source_exists] = mesh.property_map<Vertex_index, T>(name);
+
+	if(!source_exists)
+		return;
+
+	auto [target, created] = part.add_property_map<Vertex_index, T>(name);
+
+	for(auto v : mesh.vertices())
+	{
+		if(part_vertices[v] != Surface_mesh::null_vertex())
+			target[part_vertices[v]] = source[v];
+	}
+}
+
+// Recopie l'attribut 'name' du sommet 'source' de 'mesh' sur le sommet 'target' de 'part'
+template <class T>
+void copy_vertex_value(const Surface_mesh& mesh, Vertex_index source, Surface_mesh& part,
+					   Vertex_index target, const std::string& name)
+{
+	auto [source_map, source_exists] = mesh.property_map<Vertex_index, T>(name);
+	auto [target_map, target_exists] = part.property_map<Vertex_index, T>(name);
+
+	if(source_exists && target_exists)
+		target_map[target] = source_map[source];
+}
+
+// Ajoute à 'part' un nouveau sommet copiant le sommet 'v' de 'mesh' (position et attributs)
+Vertex_index duplicate_vertex(const Surface_mesh& mesh, Vertex_index v, Surface_mesh& part)
+{
+	Vertex_index copy = part.add_vertex(mesh.point(v));
+
+	copy_vertex_value<Kernel::Vector_3>(mesh, v, part, copy, "v:normal");
+	copy_vertex_value<std::array<float, 4>>(mesh, v, part, copy, "v:color");
+	copy_vertex_value<Kernel::Vector_2>(mesh, v, part, copy, "v:texcoord");
+	copy_vertex_value<Vertex_mark>(mesh, v, part, copy, "v:mark");
+
+	return copy;
+}
+
+// Ajoute la face 'f' de 'mesh' à 'part'. Un sous-ensemble de faces peut rendre un sommet non
+// manifold (faces en papillon autour du sommet) et add_face échoue alors : les sommets de la face
+// déjà utilisés par d'autres faces de 'part' sont dupliqués un par un jusqu'à ce que la face
+// puisse être ajoutée (au pire la face est isolée), aucune face n'est donc perdue.
+// Renvoie le nombre de sommets dupliqués.
+size_t add_part_face(const Surface_mesh& mesh, Surface_mesh::Face_index f, Surface_mesh& part,
+					 const std::vector<Vertex_index>& part_vertices,
+					 std::vector<Vertex_index>& mesh_face_vertices,
+					 std::vector<Vertex_index>& face_vertices)
+{
+	mesh_face_vertices.clear();
+	face_vertices.clear();
+
+	for(auto v : CGAL::vertices_around_face(mesh.halfedge(f), mesh))
+	{
+		mesh_face_vertices.push_back(v);
+		face_vertices.push_back(part_vertices[v]);
+	}
+
+	size_t nb_duplicates = 0;
+
+	for(size_t i = 0; part.add_face(face_vertices) == Surface_mesh::null_face(); ++i)
+	{
+		// Les sommets encore isolés ne peuvent pas être la cause de l'échec
+		while(i < face_vertices.size() && part.is_isolated(face_vertices[i]))
+			++i;
+
+		// Une face dont tous les sommets sont isolés s'ajoute toujours
+		assert(i < face_vertices.size());
+
+		if(i == face_vertices.size())
+			break;
+
+		face_vertices[i] = duplicate_vertex(mesh, mesh_face_vertices[i], part);
+		++nb_duplicates;
+	}
+
+	return nb_duplicates;
+}
+
+} // namespace
+
+std::vector<Surface_mesh> split_faces(const Surface_mesh& mesh,
+									  const std::vector<unsigned char>& face_parts,
+									  size_t nb_parts)
+{
+	// Parties auxquelles appartient chaque sommet (union des masques de ses faces)
+	std::vector<unsigned char> vertex_parts(mesh.num_vertices(), 0);
+
+	std::vector<size_t> nb_part_vertices(nb_parts, 0);
+	std::vector<size_t> nb_part_faces(nb_parts, 0);
+
+	for(auto f : mesh.faces())
+	{
+		unsigned char parts = face_parts[f];
+
+		if(parts == 0)
+			continue;
+
+		for(auto v : CGAL::vertices_around_face(mesh.halfedge(f), mesh))
+		{
+			unsigned char new_parts = parts & ~vertex_parts[v];
+
+			for(size_t p = 0; p < nb_parts; ++p)
+			{
+				if(new_parts & (1u << p))
+					++nb_part_vertices[p];
+			}
+
+			vertex_parts[v] |= parts;
+		}
+
+		for(size_t p = 0; p < nb_parts; ++p)
+		{
+			if(parts & (1u << p))
+				++nb_part_faces[p];
+		}
+	}
+
+	std::vector<Surface_mesh> result(nb_parts);
+	std::vector<Vertex_index> part_vertices(mesh.num_vertices());
+	std::vector<Vertex_index> mesh_face_vertices;
+	std::vector<Vertex_index> face_vertices;
+
+	for(size_t p = 0; p < nb_parts; ++p)
+	{
+		Surface_mesh& part		 = result[p];
+		const unsigned char mask = static_cast<unsigned char>(1u << p);
+
+		// Relation d'Euler (arêtes ≈ sommets + faces) pour réserver les arêtes
+		part.reserve(static_cast<Surface_mesh::size_type>(nb_part_vertices[p]),
+					 static_cast<Surface_mesh::size_type>(nb_part_vertices[p] + nb_part_faces[p]),
+					 static_cast<Surface_mesh::size_type>(nb_part_faces[p]));
+
+		std::fill(part_vertices.begin(), part_vertices.end(), Surface_mesh::null_vertex());
+
+		for(auto v : mesh.vertices())
+		{
+			if(vertex_parts[v] & mask)
+				part_vertices[v] = part.add_vertex(mesh.point(v));
+		}
+
+		copy_vertex_property<Kernel::Vector_3>(mesh, part, part_vertices, "v:normal");
+		copy_vertex_property<std::array<float, 4>>(mesh, part, part_vertices, "v:color");
+		copy_vertex_property<Kernel::Vector_2>(mesh, part, part_vertices, "v:texcoord");
+		copy_vertex_property<Vertex_mark>(mesh, part, part_vertices, "v:mark");
+
+		size_t nb_duplicates = 0;
+
+		for(auto f : mesh.faces())
+		{
+			if(face_parts[f] & mask)
+				nb_duplicates += add_part_face(mesh, f, part, part_vertices, mesh_face_vertices,
+											   face_vertices);
+		}
+
+		if(nb_duplicates > 0)
+		{
+			std::clog << "[STATUS] split_faces : " << nb_duplicates
+					  << " vertices duplicated in part " << p << '\n';
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,27 @@
+#ifndef MESH_DIVISION_HPP
+#define MESH_DIVISION_HPP
+
+// PROJECT
+
+#include "../instance/Surface_mesh.hpp"
+
+// STD
+
+#include <cstddef>
+#include <vector>
+
+// Répartit les faces de 'mesh' entre 'nb_parts' sous-maillages (au plus 8) construits directement,
+// en une passe, sans copier 'mesh' ni effacer de faces : face_parts[f] (indexé par Face_index)
+// est un masque dont le bit p indique que la face f appartient à la partie p. Une face peut
+// appartenir à plusieurs parties, ses sommets sont alors dupliqués dans chacune d'elles.
+//
+// Les sommets de chaque partie sont ceux de ses faces, renumérotés de façon compacte dans leur
+// ordre dans 'mesh' (les parties n'ont pas d'éléments effacés). Les positions et les attributs
+// 'v:normal', 'v:color', 'v:texcoord' et 'v:mark' sont recopiés. Toutes les faces sont conservées :
+// un sommet qu'une partie rendrait non manifold est dupliqué (copies ajoutées après les autres
+// sommets de la partie).
+std::vector<Surface_mesh> split_faces(const Surface_mesh& mesh,
+									  const std::vector<unsigned char>& face_parts,
+									  size_t nb_parts);
+
+#endif // MESH_DIVISION_HPP
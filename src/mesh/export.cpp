@@ -1,7 +1,13 @@
 #include "export.hpp"
 
+// PROJECT
+
+#include "indexing.hpp"
+#include "optimization.hpp"
+
 // STD
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -19,7 +25,7 @@ std::unique_ptr<aiMesh> make_ai_mesh(const Surface_mesh& surface_mesh)
 
 	aiMesh* mesh_data = new aiMesh();
 
-	std::map<Vertex_index, unsigned int> indice_map;
+	Dense_vertex_index dense_index(surface_mesh);
 
 	mesh_data->mNumVertices = surface_mesh.number_of_vertices();
 
@@ -36,7 +42,6 @@ std::unique_ptr<aiMesh> make_ai_mesh(const Surface_mesh& surface_mesh)
 			mesh_data->mVertices[i] = {static_cast<float>(position[0]),
 									   static_cast<float>(position[1]),
 									   static_cast<float>(position[2])};
-			indice_map[v]			= i;
 			++i;
 		}
 	}
@@ -132,7 +137,7 @@ std::unique_ptr<aiMesh> make_ai_mesh(const Surface_mesh& surface_mesh)
 
 			for(auto v : face_vertices)
 			{
-				mesh_data->mFaces[f].mIndices[i] = indice_map[v];
+				mesh_data->mFaces[f].mIndices[i] = dense_index[v];
 				++i;
 			}
 
@@ -143,6 +148,51 @@ std::unique_ptr<aiMesh> make_ai_mesh(const Surface_mesh& surface_mesh)
 	return std::unique_ptr<aiMesh>(mesh_data);
 }
 
+std::pair<double, double> optimize_ai_mesh(aiMesh& mesh)
+{
+	Triangle_list triangles(mesh.mNumFaces);
+
+	for(unsigned int f = 0; f < mesh.mNumFaces; ++f)
+	{
+		const aiFace& face = mesh.mFaces[f];
+
+		if(face.mNumIndices != 3)
+		{
+			std::cerr << "[WARNING] optimize_ai_mesh : non triangular face, mesh not optimized\n";
+			return {0.0, 0.0};
+		}
+
+		triangles[f] = {face.mIndices[0], face.mIndices[1], face.mIndices[2]};
+	}
+
+	double acmr_before = average_cache_miss_ratio(triangles, mesh.mNumVertices);
+
+	auto remap = optimize_triangles(triangles, mesh.mNumVertices);
+
+	// Toutes les faces ont 3 index : elles sont réécrites en place dans le nouvel ordre
+	for(unsigned int f = 0; f < mesh.mNumFaces; ++f)
+		std::copy(triangles[f].begin(), triangles[f].end(), mesh.mFaces[f].mIndices);
+
+	remap_vertices(mesh.mVertices, remap);
+
+	if(mesh.mNormals)
+		remap_vertices(mesh.mNormals, remap);
+
+	for(unsigned int c = 0; c < AI_MAX_NUMBER_OF_COLOR_SETS; ++c)
+	{
+		if(mesh.mColors[c])
+			remap_vertices(mesh.mColors[c], remap);
+	}
+
+	for(unsigned int t = 0; t < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++t)
+	{
+		if(mesh.mTextureCoords[t])
+			remap_vertices(mesh.mTextureCoords[t], remap);
+	}
+
+	return {acmr_before, average_cache_miss_ratio(triangles, mesh.mNumVertices)};
+}
+
 void assign_scene_mesh(aiScene* scene, unsigned int scene_mesh_index,
 					   aiMesh* new_mesh)
 {
@@ -153,15 +203,24 @@ void assign_scene_mesh(aiScene* scene, unsigned int scene_mesh_index,
 aiReturn export_scene(const std::string& format, const std::string& filename,
 					  const aiScene* scene)
 {
-	Assimp::Exporter exporter;
-
-	auto res = exporter.Export(scene, format, filename);
+	auto status = try_export_scene(format, filename, scene);
 
-	if(res != aiReturn_SUCCESS)
+	if(!status)
 	{
-		std::cerr << "[ERROR] ASSIMP : " << exporter.GetErrorString() << '\n';
+		std::cerr << "[ERROR] " << status.error() << '\n';
 		exit(EXIT_FAILURE);
 	}
 
-	return res;
+	return aiReturn_SUCCESS;
+}
+
+Status try_export_scene(const std::string& format, const std::string& filename,
+						const aiScene* scene)
+{
+	Assimp::Exporter exporter;
+
+	if(exporter.Export(scene, format, filename) != aiReturn_SUCCESS)
+		return Error{"ASSIMP : " + std::string(exporter.GetErrorString())};
+
+	return {};
 }
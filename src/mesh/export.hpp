@@ -4,12 +4,14 @@
 // PROJECT
 
 #include "../instance/Surface_mesh.hpp"
+#include "result.hpp"
 
 // STD
 
 #include <array>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 // ASSIMP
@@ -19,10 +21,18 @@
 // Convertie Surface_mesh en aiMesh pour l'exportation 
 std::unique_ptr<aiMesh> make_ai_mesh(const Surface_mesh& surface_mesh);
 
+// Réordonne les faces et les sommets de 'mesh' pour le cache des sommets du GPU (cf.
+// optimization.hpp) et renvoie l'ACMR avant et après. Le maillage n'est pas modifié s'il contient
+// des faces qui ne sont pas des triangles (l'ACMR renvoyé est alors nul).
+std::pair<double, double> optimize_ai_mesh(aiMesh& mesh);
+
 void assign_scene_mesh(aiScene* scene, unsigned int scene_mesh_index,
 					   aiMesh* new_mesh);
 
+// Quitte le programme si l'exportation échoue, try_export_scene renvoie l'erreur à la place.
 aiReturn export_scene(const std::string& format, const std::string& filename,
 					  const aiScene* scene);
+Status try_export_scene(const std::string& format, const std::string& filename,
+						const aiScene* scene);
 
 #endif // MESH_EXPORT_HPP
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "flat.hpp"
+
+// PROJECT
+
+#include "adjacency.hpp"
+
+// CGAL
+
+#include <CGAL/boost/graph/iterator.h>
+
+// STD
+
+#include <utility>
+
+size_t Flat_mesh::size() const
+{
+	return vertices.size();
+}
+
+bool Flat_mesh::has_normals() const
+{
+	return !nx.empty();
+}
+
+Kernel::Point_3 Flat_mesh::point(size_t i) const
+{
+	return {x[i], y[i], z[i]};
+}
+
+Kernel::Vector_3 Flat_mesh::normal(size_t i) const
+{
+	return {nx[i], ny[i], nz[i]};
+}
+
+Flat_mesh make_flat_mesh(const Surface_mesh& mesh)
+{
+	using Vertex_index = Surface_mesh::Vertex_index;
+	using Vector_3	   = Kernel::Vector_3;
+
+	Flat_mesh flat_mesh;
+
+	// Adjacence (et ordre des sommets) partagée avec les parcours de voisinage sur Surface_mesh
+	Vertex_adjacency adjacency = make_vertex_adjacency(mesh);
+
+	flat_mesh.vertices		   = std::move(adjacency.vertices);
+	flat_mesh.neighbor_offsets = std::move(adjacency.offsets);
+	flat_mesh.neighbors		   = std::move(adjacency.neighbors);
+
+	size_t nb_vertices = flat_mesh.vertices.size();
+
+	auto [normal_map, normal_map_exist] =
+		mesh.template property_map<Vertex_index, Vector_3>("v:normal");
+
+	auto [marking_map, marking_map_exist] =
+		mesh.template property_map<Vertex_index, Vertex_mark>("v:mark");
+
+	flat_mesh.x.reserve(nb_vertices);
+	flat_mesh.y.reserve(nb_vertices);
+	flat_mesh.z.reserve(nb_vertices);
+
+	if(normal_map_exist)
+	{
+		flat_mesh.nx.reserve(nb_vertices);
+		flat_mesh.ny.reserve(nb_vertices);
+		flat_mesh.nz.reserve(nb_vertices);
+	}
+
+	if(marking_map_exist)
+		flat_mesh.marks.reserve(nb_vertices);
+
+	// Sommets
+	for(auto v : flat_mesh.vertices)
+	{
+		const auto& p = mesh.point(v);
+		flat_mesh.x.push_back(p[0]);
+		flat_mesh.y.push_back(p[1]);
+		flat_mesh.z.push_back(p[2]);
+
+		if(normal_map_exist)
+		{
+			const auto& n = normal_map[v];
+			flat_mesh.nx.push_back(n[0]);
+			flat_mesh.ny.push_back(n[1]);
+			flat_mesh.nz.push_back(n[2]);
+		}
+
+		if(marking_map_exist)
+			flat_mesh.marks.push_back(marking_map[v]);
+	}
+
+	// Index dense de chaque sommet (les sommets effacés n'en ont pas)
+	flat_mesh.dense_index = Dense_vertex_index(mesh);
+
+	// Triangles
+	flat_mesh.triangles.reserve(mesh.number_of_faces());
+
+	for(auto f : mesh.faces())
+	{
+		auto face_vertices = CGAL::vertices_around_face(mesh.halfedge(f), mesh);
+
+		if(face_vertices.size() != 3)
+			continue;
+
+		auto v_it = face_vertices.begin();
+
+		std::array<unsigned int, 3> triangle;
+
+		for(auto& index : triangle)
+		{
+			index = flat_mesh.dense_index[*v_it];
+			++v_it;
+		}
+
+		flat_mesh.triangles.push_back(triangle);
+	}
+
+	return flat_mesh;
+}
+
+void sync_surface_mesh(const Flat_mesh& flat_mesh, Surface_mesh& mesh)
+{
+	using Vertex_index = Surface_mesh::Vertex_index;
+
+	for(size_t i = 0; i < flat_mesh.size(); ++i)
+		mesh.point(flat_mesh.vertices[i]) = flat_mesh.point(i);
+
+	if(!flat_mesh.marks.empty())
+	{
+		auto [marking_map, created] =
+			mesh.template add_property_map<Vertex_index, Vertex_mark>("v:mark");
+
+		for(size_t i = 0; i < flat_mesh.size(); ++i)
+			marking_map[flat_mesh.vertices[i]] = flat_mesh.marks[i];
+	}
+}
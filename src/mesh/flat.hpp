@@ -0,0 +1,58 @@
+#ifndef MESH_FLAT_HPP
+#define MESH_FLAT_HPP
+
+// PROJECT
+
+#include "../instance/Surface_mesh.hpp"
+#include "indexing.hpp"
+
+// STD
+
+#include <array>
+#include <vector>
+
+// Défini dans marking.hpp
+enum class Vertex_mark : unsigned char;
+
+// Vue compacte "structure de tableaux" d'un Surface_mesh utilisée par les noyaux numériques
+// (projection, annotation). Les sommets sont renumérotés de façon dense : le sommet i correspond
+// au sommet 'vertices[i]' du Surface_mesh d'origine.
+struct Flat_mesh
+{
+	std::vector<Surface_mesh::Vertex_index> vertices;
+
+	// Inverse de 'vertices' : index dense d'un sommet du Surface_mesh d'origine (permet de lire
+	// les tableaux à partir des résultats d'un SM_kd_tree construit sur ce maillage)
+	Dense_vertex_index dense_index;
+
+	// Positions et normales (les normales sont vides si le maillage n'en a pas)
+	std::vector<double> x, y, z;
+	std::vector<double> nx, ny, nz;
+
+	// Adjacence des sommets au format CSR : les voisins du sommet i sont
+	// neighbors[neighbor_offsets[i]] ... neighbors[neighbor_offsets[i + 1] - 1]
+	std::vector<unsigned int> neighbor_offsets;
+	std::vector<unsigned int> neighbors;
+
+	// Faces triangulaires (index denses), les faces non triangulaires sont ignorées
+	std::vector<std::array<unsigned int, 3>> triangles;
+
+	// Annotations des sommets (vide tant que le maillage n'a pas été annoté)
+	std::vector<Vertex_mark> marks;
+
+	size_t size() const;
+	bool has_normals() const;
+
+	Kernel::Point_3 point(size_t i) const;
+	Kernel::Vector_3 normal(size_t i) const;
+};
+
+// Construit la vue compacte d'un maillage (positions, normales 'v:normal', annotations 'v:mark',
+// adjacence et triangles).
+Flat_mesh make_flat_mesh(const Surface_mesh& mesh);
+
+// Recopie les positions (et les annotations si elles existent) de la vue compacte dans le maillage
+// à partir duquel elle a été construite.
+void sync_surface_mesh(const Flat_mesh& flat_mesh, Surface_mesh& mesh);
+
+#endif // MESH_FLAT_HPP
@@ -1,9 +1,16 @@
 #include "import.hpp"
 
+// PROJECT
+
+#include "conversion.hpp"
+#include "reader.hpp"
+
 // STD
 
 #include <iostream>
+#include <limits>
 #include <string>
+#include <utility>
 
 // ASSIMP
 
@@ -80,6 +87,19 @@ unsigned int find_mesh_index(const aiScene* scene, const aiNode* node)
 }
 
 std::unique_ptr<aiScene> import_scene(const std::string& filename)
+{
+	auto scene = try_import_scene(filename);
+
+	if(!scene)
+	{
+		std::cerr << "[ERROR] " << scene.error() << '\n';
+		exit(EXIT_FAILURE);
+	}
+
+	return std::move(*scene);
+}
+
+Result<std::unique_ptr<aiScene>> try_import_scene(const std::string& filename)
 {
 	// [WARNING] scene data should not be read after importer is
 	// destroyed because he is in charge of memory allocation.
@@ -94,10 +114,7 @@ std::unique_ptr<aiScene> import_scene(const std::string& filename)
 	aiScene* scene = importer.GetOrphanedScene();
 
 	if(!scene)
-	{
-		std::cerr << "[ERROR] ASSIMP : " << importer.GetErrorString() << '\n';
-		exit(EXIT_FAILURE);
-	}
+		return Error{"ASSIMP : " + std::string(importer.GetErrorString())};
 
 	return std::unique_ptr<aiScene>(scene);
 }
@@ -161,6 +178,10 @@ Surface_mesh make_surface_mesh(const aiMesh* mesh_data)
 
 	Surface_mesh surface_mesh;
 
+	surface_mesh.reserve(static_cast<size_type>(mesh_data->mNumVertices),
+						 static_cast<size_type>(mesh_data->mNumVertices + mesh_data->mNumFaces),
+						 static_cast<size_type>(mesh_data->mNumFaces));
+
 	if(mesh_data->HasPositions())
 	{
 		for(unsigned int i = 0; i < mesh_data->mNumVertices; ++i)
@@ -255,4 +276,52 @@ Surface_mesh make_surface_mesh(const aiMesh* mesh_data)
 	}
 
 	return surface_mesh;
-}
\ No newline at end of file
+}
+
+std::pair<Surface_mesh, std::string> import_surface_mesh(const std::string& filename)
+{
+	auto mesh = try_import_surface_mesh(filename);
+
+	if(!mesh)
+	{
+		std::cerr << "[ERROR] " << mesh.error() << '\n';
+		exit(EXIT_FAILURE);
+	}
+
+	return std::move(*mesh);
+}
+
+Result<std::pair<Surface_mesh, std::string>> try_import_surface_mesh(const std::string& filename)
+{
+	if(has_native_reader(filename))
+	{
+		auto mesh_data = read_mesh_data(filename);
+
+		if(mesh_data)
+		{
+			std::string texture_path = mesh_data->texture_path.value_or("");
+			return std::pair<Surface_mesh, std::string>{to_surface_mesh(*mesh_data),
+														texture_path};
+		}
+
+		std::clog << "[STATUS] falling back to assimp to read " << filename << '\n';
+	}
+
+	auto scene = try_import_scene(filename);
+
+	if(!scene)
+		return Error{scene.error()};
+
+	print_scene_status(scene->get());
+
+	unsigned int mesh_index = find_mesh_index(scene->get());
+
+	if(mesh_index == std::numeric_limits<unsigned int>::max())
+		return Error{filename + " does not contain any triangle mesh"};
+
+	auto mesh_data		  = (*scene)->mMeshes[mesh_index];
+	auto mesh_material	  = (*scene)->mMaterials[mesh_data->mMaterialIndex];
+	auto mesh_texture_path = find_texture_path(filename, mesh_material);
+
+	return std::pair<Surface_mesh, std::string>{make_surface_mesh(mesh_data), mesh_texture_path};
+}
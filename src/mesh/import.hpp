@@ -5,12 +5,14 @@
 
 #include "../instance/Surface_mesh.hpp"
 #include "data.hpp"
+#include "result.hpp"
 
 // STD
 
 #include <array>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 // ASSIMP
@@ -18,7 +20,9 @@
 #include <assimp/scene.h>
 
 // Renvoie une structure de scene assimp à partir d'un fichier contenant une description d'objets géométriques.
+// Quitte le programme si le fichier ne peut pas être lu, try_import_scene renvoie l'erreur à la place.
 std::unique_ptr<aiScene> import_scene(const std::string& filename);
+Result<std::unique_ptr<aiScene>> try_import_scene(const std::string& filename);
 void print_scene_status(const aiScene* scene);
 
 // Renvoie L'identifiant du premier maillage trouvé dans la scène sinon renvoie std::numeric_limits<unsigned int>::max().
@@ -33,4 +37,12 @@ std::string find_texture_path(const std::string& filename,
 // Construie une Surface_mesh à partir d'une aiMesh contenu dans une scene aiScene.
 Surface_mesh make_surface_mesh(const aiMesh* mesh_data);
 
+// Construit une Surface_mesh à partir d'un fichier et renvoie aussi le chemin de sa texture (vide
+// s'il n'y en a pas). Les fichiers PLY et OBJ sont lus directement (cf. reader.hpp), les autres
+// formats et les fichiers non supportés par le lecteur natif passent par assimp.
+// Quitte le programme si le fichier ne peut pas être lu ou ne contient aucun maillage,
+// try_import_surface_mesh renvoie l'erreur à la place.
+std::pair<Surface_mesh, std::string> import_surface_mesh(const std::string& filename);
+Result<std::pair<Surface_mesh, std::string>> try_import_surface_mesh(const std::string& filename);
+
 #endif // MESH_IMPORT_HPP
\ No newline at end of file
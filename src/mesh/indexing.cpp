@@ -0,0 +1,30 @@
+#include "indexing.hpp"
+
+Dense_vertex_index::Dense_vertex_index() : m_size(0)
+{
+}
+
+Dense_vertex_index::Dense_vertex_index(const Surface_mesh& mesh)
+	: m_size(mesh.number_of_vertices())
+{
+	if(mesh.number_of_removed_vertices() == 0)
+		return;
+
+	// Les sommets effacés gardent l'index 0, ils ne sont jamais référencés par une face
+	m_index.resize(mesh.number_of_vertices() + mesh.number_of_removed_vertices(), 0);
+
+	unsigned int i = 0;
+
+	for(auto v : mesh.vertices())
+		m_index[v] = i++;
+}
+
+bool Dense_vertex_index::is_identity() const
+{
+	return m_index.empty();
+}
+
+size_t Dense_vertex_index::size() const
+{
+	return m_size;
+}
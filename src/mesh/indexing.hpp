@@ -0,0 +1,42 @@
+#ifndef MESH_INDEXING_HPP
+#define MESH_INDEXING_HPP
+
+// PROJECT
+
+#include "../instance/Surface_mesh.hpp"
+
+// STD
+
+#include <vector>
+
+// Renumérotation dense des sommets d'une Surface_mesh : le i-ème sommet parcouru par
+// mesh.vertices() reçoit l'index i (c'est la numérotation des tableaux de Mesh_data, aiMesh et
+// Flat_mesh). Si le maillage n'a pas de sommets effacés, les index de CGAL sont déjà denses et
+// aucun tableau n'est construit, sinon l'index dense est lu dans un tableau indexé par Vertex_index.
+class Dense_vertex_index
+{
+  public:
+	// Numérotation vide (aucun sommet)
+	Dense_vertex_index();
+	explicit Dense_vertex_index(const Surface_mesh& mesh);
+
+	// Vrai si les index de CGAL sont utilisés tels quels (aucun sommet effacé)
+	bool is_identity() const;
+
+	// Nombre de sommets renumérotés
+	size_t size() const;
+
+	unsigned int operator[](Surface_mesh::Vertex_index v) const;
+
+  protected:
+	size_t m_size;
+	std::vector<unsigned int> m_index; // vide si is_identity()
+};
+
+// Appelé pour chaque coin de face : défini dans l'en-tête pour pouvoir être inliné
+inline unsigned int Dense_vertex_index::operator[](Surface_mesh::Vertex_index v) const
+{
+	return m_index.empty() ? static_cast<unsigned int>(v) : m_index[v];
+}
+
+#endif // MESH_INDEXING_HPP
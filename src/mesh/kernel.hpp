@@ -0,0 +1,180 @@
+#ifndef MESH_KERNEL_HPP
+#define MESH_KERNEL_HPP
+
+// STD
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Noyau utilisé pour changer les paramètre de la projection d'un maillage sur un autre.
+struct Weight_kernel
+{
+	enum class Type
+	{
+		Gaussian,
+		Wendland,
+		Singular,
+		Uniform
+	};
+
+	enum Mode
+	{
+		Constant,
+		Max,
+		Adaptive
+	};
+
+	Type type		 = Type::Gaussian;
+	Mode radius_mode = Mode::Adaptive;
+
+	double radius	  = 0;
+	double s_exponent = 0;
+
+	// Constant : r = radius
+	// Max      : r = max(radius , max(r[i] , i \in neighbors))
+	// Adaptive : r = max(r[i] , i \in neighbors)
+
+	double support_radius(double neihboringSphereRadius) const;
+
+	double weight(double d, double neihboringSphereRadius) const;
+};
+
+// Voisinage d'un point rangé en structure de tableaux pour que les poids et les moments soient
+// calculés par des boucles vectorisables. Un voisinage sert de mémoire de travail à APSS : il est
+// créé une fois par thread (ou par bloc de sommets) puis réutilisé, la mémoire n'est donc allouée
+// qu'à la première projection.
+struct APSS_neighborhood
+{
+	std::vector<double> px, py, pz;	// positions
+	std::vector<double> nx, ny, nz;	// normales
+	std::vector<double> sqr_dist;	// distances au carré au point projeté
+	std::vector<double> w;			// poids
+
+	size_t size() const;
+	void resize(size_t size);
+};
+
+// Sommes pondérées d'un voisinage nécessaires à l'ajustement d'une sphère algébrique
+struct APSS_moments
+{
+	double s_wi		= 0;
+	double s_wipini = 0;
+	double s_wipipi = 0;
+
+	std::array<double, 3> s_wipi = {0, 0, 0};
+	std::array<double, 3> s_wini = {0, 0, 0};
+};
+
+// Rayon du noyau en fonction du rayon du voisinage courant (politiques de Weight_kernel::Mode)
+struct Constant_radius
+{
+	double radius = 0;
+
+	double operator()(double neihboringSphereRadius) const;
+};
+
+struct Max_radius
+{
+	double radius = 0;
+
+	double operator()(double neihboringSphereRadius) const;
+};
+
+struct Adaptive_radius
+{
+	double operator()(double neihboringSphereRadius) const;
+};
+
+// Noyaux de poids dont le type et le mode de rayon sont fixés à la compilation. Ils s'utilisent à
+// la place de Weight_kernel dans APSS et projection : la boucle de calcul des poids ne contient
+// alors ni branchement ni appel à std::exp ou std::pow (sauf pour un exposant de Singular dont la
+// moitié n'est pas entière). Les poids Gaussian et Wendland sont calculés 4 par 4 en AVX2 si le
+// processeur le permet (cf. gaussian_weights, wendland_weights).
+template <class Radius = Adaptive_radius>
+struct Gaussian_kernel
+{
+	Radius radius;
+
+	double weight(double d, double neihboringSphereRadius) const;
+	void compute_weights(APSS_neighborhood& neighborhood, double neihboringSphereRadius) const;
+};
+
+template <class Radius = Adaptive_radius>
+struct Wendland_kernel
+{
+	Radius radius;
+
+	double weight(double d, double neihboringSphereRadius) const;
+	void compute_weights(APSS_neighborhood& neighborhood, double neihboringSphereRadius) const;
+};
+
+template <class Radius = Adaptive_radius>
+struct Singular_kernel
+{
+	Radius radius;
+	double s_exponent = 0;
+
+	double weight(double d, double neihboringSphereRadius) const;
+	void compute_weights(APSS_neighborhood& neighborhood, double neihboringSphereRadius) const;
+};
+
+template <class Radius = Adaptive_radius>
+struct Uniform_kernel
+{
+	Radius radius;
+
+	double weight(double d, double neihboringSphereRadius) const;
+	void compute_weights(APSS_neighborhood& neighborhood, double neihboringSphereRadius) const;
+};
+
+// Appelle 'function' avec le noyau compilé correspondant à 'weight_kernel'. Le choix est fait une
+// seule fois, tous les appels de 'function' doivent renvoyer le même type.
+template <class Function>
+auto dispatch_weight_kernel(const Weight_kernel& weight_kernel, Function&& function);
+
+// Calcule les poids avec le type de noyau choisi à l'exécution
+void compute_weights(APSS_neighborhood& neighborhood, const Weight_kernel& weight_kernel,
+					 double neihboringSphereRadius);
+
+// Les fonctions suivantes existent en version scalaire et AVX2 (4 voisins par instruction) : la
+// version AVX2 est choisie à l'exécution si le processeur la supporte. Les deux versions font les
+// mêmes opérations dans le même ordre (sommes sur 4 voies, sans FMA) et donnent donc les mêmes
+// résultats au bit près, quel que soit le processeur. Seule une compilation de la version scalaire
+// autorisant la fusion des multiplications-additions (ex: -march=native avec -ffp-contract=fast)
+// peut introduire un écart, de l'ordre de l'erreur d'arrondi de chaque terme.
+
+// Exponentielle de gaussian_weights (version scalaire, la version AVX2 fait les mêmes opérations) :
+// réduction d'argument et polynôme de Taylor d'ordre 13. Sur [-700, 0], qui contient les arguments
+// -d^2 / r^2 des poids (dans [-1, 0] en mode Adaptive), l'erreur relative par rapport à std::exp
+// est inférieure à kernel_exp_max_relative_error = 2^-51 (mesurée : 2.22e-16, cf. bench accuracy).
+// En dessous de -700, l'argument est borné à -700 (exp(-700) ~ 1e-304).
+double kernel_exp(double x);
+
+constexpr double kernel_exp_max_relative_error = 4.440892098500626e-16; // 2^-51
+
+// w[i] = exp(-sqr_dist[i] * inv_sqr_r), calculé par kernel_exp
+void gaussian_weights(const double* sqr_dist, double* w, size_t n, double inv_sqr_r);
+void gaussian_weights_scalar(const double* sqr_dist, double* w, size_t n, double inv_sqr_r);
+
+// w[i] = (1 - u)^4 (1 + 4u) avec u = sqrt(sqr_dist[i]) * inv_r
+void wendland_weights(const double* sqr_dist, double* w, size_t n, double inv_r);
+void wendland_weights_scalar(const double* sqr_dist, double* w, size_t n, double inv_r);
+
+// Accumule les moments du voisinage
+APSS_moments accumulate_moments(const APSS_neighborhood& neighborhood);
+APSS_moments accumulate_moments_scalar(const APSS_neighborhood& neighborhood);
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MESH_KERNEL_HAS_AVX2
+void gaussian_weights_avx2(const double* sqr_dist, double* w, size_t n, double inv_sqr_r);
+void wendland_weights_avx2(const double* sqr_dist, double* w, size_t n, double inv_r);
+APSS_moments accumulate_moments_avx2(const APSS_neighborhood& neighborhood);
+#endif
+
+// Indique si les versions AVX2 sont utilisées
+bool has_avx2_kernels();
+
+#include "kernel.inl"
+
+#endif // MESH_KERNEL_HPP
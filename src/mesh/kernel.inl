@@ -0,0 +1,521 @@
+#ifndef MESH_KERNEL_INL
+#define MESH_KERNEL_INL
+
+#include "kernel.hpp"
+
+// STD
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+#ifdef MESH_KERNEL_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+double Weight_kernel::support_radius(double neihboringSphereRadius) const
+{
+	return radius_mode == Mode::Constant
+			   ? radius
+			   : radius_mode == Mode::Max ? std::max<double>(radius, neihboringSphereRadius)
+										  : neihboringSphereRadius;
+}
+
+double Weight_kernel::weight(double d, double neihboringSphereRadius) const
+{
+	double r = support_radius(neihboringSphereRadius);
+
+	if(type == Type::Gaussian)
+		return std::exp(-d * d / (r * r));
+	else if(type == Type::Wendland)
+		return std::pow(1 - d / r, 4) * (1 + 4 * d / r);
+	else if(type == Type::Singular)
+		return std::pow(r / d, s_exponent);
+	else
+		return 1.0;
+}
+
+size_t APSS_neighborhood::size() const
+{
+	return w.size();
+}
+
+void APSS_neighborhood::resize(size_t size)
+{
+	px.resize(size);
+	py.resize(size);
+	pz.resize(size);
+	nx.resize(size);
+	ny.resize(size);
+	nz.resize(size);
+	sqr_dist.resize(size);
+	w.resize(size);
+}
+
+double Constant_radius::operator()(double) const
+{
+	return radius;
+}
+
+double Max_radius::operator()(double neihboringSphereRadius) const
+{
+	return std::max<double>(radius, neihboringSphereRadius);
+}
+
+double Adaptive_radius::operator()(double neihboringSphereRadius) const
+{
+	return neihboringSphereRadius;
+}
+
+// exp(x) = 2^k exp(r) avec k = round(x / ln 2),
+// r = x - k ln 2 (ln 2 en deux parties pour que k ln 2 soit exact) et exp(r) évalué par son
+// développement de Taylor jusqu'à l'ordre 13 (|r| <= ln 2 / 2). L'arrondi de x / ln 2 ajoute puis
+// retire 1.5 * 2^52 : k se lit alors dans les bits de poids faible et 2^k se construit sans
+// conversion, ce qui s'écrit de la même façon en scalaire et en AVX2.
+static constexpr double kernel_exp_min_argument = -700;
+static constexpr double kernel_exp_log2e		= 1.44269504088896340736;
+static constexpr double kernel_exp_ln2_hi		= 6.93147180369123816490e-01;
+static constexpr double kernel_exp_ln2_lo		= 1.90821492927058770002e-10;
+static constexpr double kernel_exp_shifter		= 6755399441055744.0;
+
+// 1 / n! pour n = 13 ... 0 (ordre de Horner)
+static constexpr double kernel_exp_coefficients[] = {
+	1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+	1.0 / 40320.0,		1.0 / 5040.0,	   1.0 / 720.0,		 1.0 / 120.0,	  1.0 / 24.0,
+	1.0 / 6.0,			0.5,			   1.0,				 1.0};
+
+double kernel_exp(double x)
+{
+	x = std::max(x, kernel_exp_min_argument);
+
+	double t = x * kernel_exp_log2e + kernel_exp_shifter;
+	double k = t - kernel_exp_shifter;
+	double r = (x - k * kernel_exp_ln2_hi) - k * kernel_exp_ln2_lo;
+
+	double p = kernel_exp_coefficients[0];
+
+	for(size_t c = 1; c < std::size(kernel_exp_coefficients); ++c)
+		p = p * r + kernel_exp_coefficients[c];
+
+	// Bits de 2^k : (k + 1023) << 52, k étant la différence des bits de t et du décalage
+	std::uint64_t t_bits, shifter_bits;
+	std::memcpy(&t_bits, &t, sizeof(t));
+	std::memcpy(&shifter_bits, &kernel_exp_shifter, sizeof(kernel_exp_shifter));
+
+	std::uint64_t scale_bits = (t_bits - shifter_bits + 1023) << 52;
+
+	double scale;
+	std::memcpy(&scale, &scale_bits, sizeof(scale));
+
+	return p * scale;
+}
+
+void gaussian_weights_scalar(const double* sqr_dist, double* w, size_t n, double inv_sqr_r)
+{
+	const double minus_inv_sqr_r = -inv_sqr_r;
+
+	for(size_t i = 0; i < n; ++i)
+		w[i] = kernel_exp(sqr_dist[i] * minus_inv_sqr_r);
+}
+
+void wendland_weights_scalar(const double* sqr_dist, double* w, size_t n, double inv_r)
+{
+	for(size_t i = 0; i < n; ++i)
+	{
+		double u  = std::sqrt(sqr_dist[i]) * inv_r;
+		double t  = 1 - u;
+		double t2 = t * t;
+
+		w[i] = (t2 * t2) * (1 + 4 * u);
+	}
+}
+
+template <class Radius>
+double Gaussian_kernel<Radius>::weight(double d, double neihboringSphereRadius) const
+{
+	double r = radius(neihboringSphereRadius);
+	return std::exp(-d * d / (r * r));
+}
+
+template <class Radius>
+void Gaussian_kernel<Radius>::compute_weights(APSS_neighborhood& neighborhood,
+											  double neihboringSphereRadius) const
+{
+	const double r = radius(neihboringSphereRadius);
+
+	gaussian_weights(neighborhood.sqr_dist.data(), neighborhood.w.data(), neighborhood.size(),
+					 1.0 / (r * r));
+}
+
+template <class Radius>
+double Wendland_kernel<Radius>::weight(double d, double neihboringSphereRadius) const
+{
+	double u  = d / radius(neihboringSphereRadius);
+	double t  = 1 - u;
+	double t2 = t * t;
+
+	return t2 * t2 * (1 + 4 * u);
+}
+
+template <class Radius>
+void Wendland_kernel<Radius>::compute_weights(APSS_neighborhood& neighborhood,
+											  double neihboringSphereRadius) const
+{
+	wendland_weights(neighborhood.sqr_dist.data(), neighborhood.w.data(), neighborhood.size(),
+					 1.0 / radius(neihboringSphereRadius));
+}
+
+template <class Radius>
+double Singular_kernel<Radius>::weight(double d, double neihboringSphereRadius) const
+{
+	return std::pow(radius(neihboringSphereRadius) / d, s_exponent);
+}
+
+template <class Radius>
+void Singular_kernel<Radius>::compute_weights(APSS_neighborhood& neighborhood,
+											  double neihboringSphereRadius) const
+{
+	const double r = radius(neihboringSphereRadius);
+
+	const size_t n		   = neighborhood.size();
+	const double* sqr_dist = neighborhood.sqr_dist.data();
+	double* w			   = neighborhood.w.data();
+
+	// (r / d)^s = (r^2 / d^2)^(s/2) : évite la racine carrée
+	const double sqr_r		  = r * r;
+	const double half_exponent = 0.5 * s_exponent;
+
+	// Exposant s pair (cas courant, ex: s = 2) : produits successifs sans appel à std::pow
+	if(half_exponent >= 0 && half_exponent <= 8 && half_exponent == std::floor(half_exponent))
+	{
+		const int power = static_cast<int>(half_exponent);
+
+		for(size_t i = 0; i < n; ++i)
+		{
+			double ratio  = sqr_r / sqr_dist[i];
+			double weight = 1;
+
+			for(int p = 0; p < power; ++p)
+				weight *= ratio;
+
+			w[i] = weight;
+		}
+
+		return;
+	}
+
+	for(size_t i = 0; i < n; ++i)
+		w[i] = std::pow(sqr_r / sqr_dist[i], half_exponent);
+}
+
+template <class Radius>
+double Uniform_kernel<Radius>::weight(double, double) const
+{
+	return 1.0;
+}
+
+template <class Radius>
+void Uniform_kernel<Radius>::compute_weights(APSS_neighborhood& neighborhood, double) const
+{
+	std::fill(neighborhood.w.begin(), neighborhood.w.end(), 1.0);
+}
+
+template <class Radius, class Function>
+auto dispatch_weight_kernel(const Weight_kernel& weight_kernel, const Radius& radius,
+							Function&& function)
+{
+	switch(weight_kernel.type)
+	{
+		case Weight_kernel::Type::Wendland:
+			return function(Wendland_kernel<Radius>{radius});
+		case Weight_kernel::Type::Singular:
+			return function(Singular_kernel<Radius>{radius, weight_kernel.s_exponent});
+		case Weight_kernel::Type::Uniform:
+			return function(Uniform_kernel<Radius>{radius});
+		default:
+			return function(Gaussian_kernel<Radius>{radius});
+	}
+}
+
+template <class Function>
+auto dispatch_weight_kernel(const Weight_kernel& weight_kernel, Function&& function)
+{
+	switch(weight_kernel.radius_mode)
+	{
+		case Weight_kernel::Mode::Constant:
+			return dispatch_weight_kernel(weight_kernel, Constant_radius{weight_kernel.radius},
+										  function);
+		case Weight_kernel::Mode::Max:
+			return dispatch_weight_kernel(weight_kernel, Max_radius{weight_kernel.radius},
+										  function);
+		default:
+			return dispatch_weight_kernel(weight_kernel, Adaptive_radius{}, function);
+	}
+}
+
+void compute_weights(APSS_neighborhood& neighborhood, const Weight_kernel& weight_kernel,
+					 double neihboringSphereRadius)
+{
+	dispatch_weight_kernel(weight_kernel, [&](const auto& kernel) {
+		kernel.compute_weights(neighborhood, neihboringSphereRadius);
+	});
+}
+
+// Somme des 4 voies dans l'ordre de horizontal_sum
+static double lane_sum(const double (&lanes)[4])
+{
+	return (lanes[0] + lanes[2]) + (lanes[1] + lanes[3]);
+}
+
+// Ajoute aux moments les voisins [begin, size) un par un (voisins restants après les blocs de 4)
+static void accumulate_remaining_moments(const APSS_neighborhood& neighborhood, size_t begin,
+										 APSS_moments& moments)
+{
+	for(size_t i = begin; i < neighborhood.size(); ++i)
+	{
+		double wi  = neighborhood.w[i];
+		double pin = neighborhood.px[i] * neighborhood.nx[i] +
+					 neighborhood.py[i] * neighborhood.ny[i] +
+					 neighborhood.pz[i] * neighborhood.nz[i];
+
+		moments.s_wipini += wi * pin;
+
+		moments.s_wipi[0] += wi * neighborhood.px[i];
+		moments.s_wipi[1] += wi * neighborhood.py[i];
+		moments.s_wipi[2] += wi * neighborhood.pz[i];
+
+		moments.s_wini[0] += wi * neighborhood.nx[i];
+		moments.s_wini[1] += wi * neighborhood.ny[i];
+		moments.s_wini[2] += wi * neighborhood.nz[i];
+
+		moments.s_wi += wi;
+	}
+}
+
+APSS_moments accumulate_moments_scalar(const APSS_neighborhood& neighborhood)
+{
+	const size_t n = neighborhood.size();
+
+	// Sommes partielles sur 4 voies : le voisin i est ajouté à la voie i % 4, comme dans la version
+	// AVX2
+	double s_w[4] = {}, s_pn[4] = {};
+	double s_px[4] = {}, s_py[4] = {}, s_pz[4] = {};
+	double s_nx[4] = {}, s_ny[4] = {}, s_nz[4] = {};
+
+	size_t i = 0;
+
+	for(; i + 4 <= n; i += 4)
+	{
+		for(size_t l = 0; l < 4; ++l)
+		{
+			double wi  = neighborhood.w[i + l];
+			double pin = neighborhood.px[i + l] * neighborhood.nx[i + l] +
+						 neighborhood.py[i + l] * neighborhood.ny[i + l] +
+						 neighborhood.pz[i + l] * neighborhood.nz[i + l];
+
+			s_w[l] += wi;
+			s_pn[l] += wi * pin;
+			s_px[l] += wi * neighborhood.px[i + l];
+			s_py[l] += wi * neighborhood.py[i + l];
+			s_pz[l] += wi * neighborhood.pz[i + l];
+			s_nx[l] += wi * neighborhood.nx[i + l];
+			s_ny[l] += wi * neighborhood.ny[i + l];
+			s_nz[l] += wi * neighborhood.nz[i + l];
+		}
+	}
+
+	APSS_moments moments;
+
+	moments.s_wi	  = lane_sum(s_w);
+	moments.s_wipini  = lane_sum(s_pn);
+	moments.s_wipi[0] = lane_sum(s_px);
+	moments.s_wipi[1] = lane_sum(s_py);
+	moments.s_wipi[2] = lane_sum(s_pz);
+	moments.s_wini[0] = lane_sum(s_nx);
+	moments.s_wini[1] = lane_sum(s_ny);
+	moments.s_wini[2] = lane_sum(s_nz);
+
+	accumulate_remaining_moments(neighborhood, i, moments);
+
+	moments.s_wipipi = moments.s_wipini;
+
+	return moments;
+}
+
+#ifdef MESH_KERNEL_HAS_AVX2
+
+// Les fonctions AVX2 n'activent pas FMA : les multiplications et additions restent séparées comme
+// dans les versions scalaires
+
+__attribute__((target("avx2"))) static double horizontal_sum(__m256d v)
+{
+	__m128d low	 = _mm256_castpd256_pd128(v);
+	__m128d high = _mm256_extractf128_pd(v, 1);
+	low			 = _mm_add_pd(low, high);
+	return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+}
+
+// Même calcul que kernel_exp sur 4 valeurs
+__attribute__((target("avx2"))) static __m256d kernel_exp_avx2(__m256d x)
+{
+	const __m256d shifter = _mm256_set1_pd(kernel_exp_shifter);
+
+	x = _mm256_max_pd(x, _mm256_set1_pd(kernel_exp_min_argument));
+
+	__m256d t = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(kernel_exp_log2e)), shifter);
+	__m256d k = _mm256_sub_pd(t, shifter);
+	__m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(kernel_exp_ln2_hi))),
+							  _mm256_mul_pd(k, _mm256_set1_pd(kernel_exp_ln2_lo)));
+
+	__m256d p = _mm256_set1_pd(kernel_exp_coefficients[0]);
+
+	for(size_t c = 1; c < std::size(kernel_exp_coefficients); ++c)
+		p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(kernel_exp_coefficients[c]));
+
+	__m256i k_bits = _mm256_sub_epi64(_mm256_castpd_si256(t), _mm256_castpd_si256(shifter));
+	__m256i scale_bits =
+		_mm256_slli_epi64(_mm256_add_epi64(k_bits, _mm256_set1_epi64x(1023)), 52);
+
+	return _mm256_mul_pd(p, _mm256_castsi256_pd(scale_bits));
+}
+
+__attribute__((target("avx2"))) void gaussian_weights_avx2(const double* sqr_dist, double* w,
+														   size_t n, double inv_sqr_r)
+{
+	const __m256d minus_inv_sqr_r = _mm256_set1_pd(-inv_sqr_r);
+
+	size_t i = 0;
+
+	for(; i + 4 <= n; i += 4)
+	{
+		__m256d d = _mm256_loadu_pd(sqr_dist + i);
+		_mm256_storeu_pd(w + i, kernel_exp_avx2(_mm256_mul_pd(d, minus_inv_sqr_r)));
+	}
+
+	gaussian_weights_scalar(sqr_dist + i, w + i, n - i, inv_sqr_r);
+}
+
+__attribute__((target("avx2"))) void wendland_weights_avx2(const double* sqr_dist, double* w,
+														   size_t n, double inv_r)
+{
+	const __m256d one	= _mm256_set1_pd(1);
+	const __m256d four	= _mm256_set1_pd(4);
+	const __m256d inv_r4 = _mm256_set1_pd(inv_r);
+
+	size_t i = 0;
+
+	for(; i + 4 <= n; i += 4)
+	{
+		__m256d u  = _mm256_mul_pd(_mm256_sqrt_pd(_mm256_loadu_pd(sqr_dist + i)), inv_r4);
+		__m256d t  = _mm256_sub_pd(one, u);
+		__m256d t2 = _mm256_mul_pd(t, t);
+
+		_mm256_storeu_pd(w + i, _mm256_mul_pd(_mm256_mul_pd(t2, t2),
+											  _mm256_add_pd(one, _mm256_mul_pd(four, u))));
+	}
+
+	wendland_weights_scalar(sqr_dist + i, w + i, n - i, inv_r);
+}
+
+__attribute__((target("avx2"))) APSS_moments
+	accumulate_moments_avx2(const APSS_neighborhood& neighborhood)
+{
+	const size_t n = neighborhood.size();
+
+	__m256d s_w	 = _mm256_setzero_pd();
+	__m256d s_pn = _mm256_setzero_pd();
+	__m256d s_px = _mm256_setzero_pd();
+	__m256d s_py = _mm256_setzero_pd();
+	__m256d s_pz = _mm256_setzero_pd();
+	__m256d s_nx = _mm256_setzero_pd();
+	__m256d s_ny = _mm256_setzero_pd();
+	__m256d s_nz = _mm256_setzero_pd();
+
+	size_t i = 0;
+
+	for(; i + 4 <= n; i += 4)
+	{
+		__m256d w  = _mm256_loadu_pd(neighborhood.w.data() + i);
+		__m256d px = _mm256_loadu_pd(neighborhood.px.data() + i);
+		__m256d py = _mm256_loadu_pd(neighborhood.py.data() + i);
+		__m256d pz = _mm256_loadu_pd(neighborhood.pz.data() + i);
+		__m256d nx = _mm256_loadu_pd(neighborhood.nx.data() + i);
+		__m256d ny = _mm256_loadu_pd(neighborhood.ny.data() + i);
+		__m256d nz = _mm256_loadu_pd(neighborhood.nz.data() + i);
+
+		__m256d pn = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(px, nx), _mm256_mul_pd(py, ny)),
+								   _mm256_mul_pd(pz, nz));
+
+		s_w	 = _mm256_add_pd(s_w, w);
+		s_pn = _mm256_add_pd(s_pn, _mm256_mul_pd(w, pn));
+		s_px = _mm256_add_pd(s_px, _mm256_mul_pd(w, px));
+		s_py = _mm256_add_pd(s_py, _mm256_mul_pd(w, py));
+		s_pz = _mm256_add_pd(s_pz, _mm256_mul_pd(w, pz));
+		s_nx = _mm256_add_pd(s_nx, _mm256_mul_pd(w, nx));
+		s_ny = _mm256_add_pd(s_ny, _mm256_mul_pd(w, ny));
+		s_nz = _mm256_add_pd(s_nz, _mm256_mul_pd(w, nz));
+	}
+
+	APSS_moments moments;
+
+	moments.s_wi	  = horizontal_sum(s_w);
+	moments.s_wipini  = horizontal_sum(s_pn);
+	moments.s_wipi[0] = horizontal_sum(s_px);
+	moments.s_wipi[1] = horizontal_sum(s_py);
+	moments.s_wipi[2] = horizontal_sum(s_pz);
+	moments.s_wini[0] = horizontal_sum(s_nx);
+	moments.s_wini[1] = horizontal_sum(s_ny);
+	moments.s_wini[2] = horizontal_sum(s_nz);
+
+	accumulate_remaining_moments(neighborhood, i, moments);
+
+	moments.s_wipipi = moments.s_wipini;
+
+	return moments;
+}
+
+#endif
+
+bool has_avx2_kernels()
+{
+#ifdef MESH_KERNEL_HAS_AVX2
+	static const bool supported = __builtin_cpu_supports("avx2");
+	return supported;
+#else
+	return false;
+#endif
+}
+
+void gaussian_weights(const double* sqr_dist, double* w, size_t n, double inv_sqr_r)
+{
+#ifdef MESH_KERNEL_HAS_AVX2
+	if(has_avx2_kernels())
+		return gaussian_weights_avx2(sqr_dist, w, n, inv_sqr_r);
+#endif
+
+	gaussian_weights_scalar(sqr_dist, w, n, inv_sqr_r);
+}
+
+void wendland_weights(const double* sqr_dist, double* w, size_t n, double inv_r)
+{
+#ifdef MESH_KERNEL_HAS_AVX2
+	if(has_avx2_kernels())
+		return wendland_weights_avx2(sqr_dist, w, n, inv_r);
+#endif
+
+	wendland_weights_scalar(sqr_dist, w, n, inv_r);
+}
+
+APSS_moments accumulate_moments(const APSS_neighborhood& neighborhood)
+{
+#ifdef MESH_KERNEL_HAS_AVX2
+	if(has_avx2_kernels())
+		return accumulate_moments_avx2(neighborhood);
+#endif
+
+	return accumulate_moments_scalar(neighborhood);
+}
+
+#endif // MESH_KERNEL_INL
@@ -0,0 +1,194 @@
+#include "loader.hpp"
+
+// PROJECT
+
+#include "conversion.hpp"
+#include "import.hpp"
+#include "optimization.hpp"
+#include "parallel.hpp"
+#include "qglmesh.hpp"
+#include "reader.hpp"
+
+// STD
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+Mesh_loader::Mesh_loader(std::vector<std::string> filenames, Surface_mesh_function process,
+						 bool optimize, unsigned int nb_threads)
+	: m_filenames(std::move(filenames)), m_process(std::move(process)), m_optimize(optimize)
+{
+	if(nb_threads == 0)
+		nb_threads = number_of_threads();
+
+	nb_threads = static_cast<unsigned int>(
+		std::min<size_t>(std::max(nb_threads, 1u), m_filenames.size()));
+
+	m_threads.reserve(nb_threads);
+
+	for(unsigned int i = 0; i < nb_threads; ++i)
+		m_threads.emplace_back(&Mesh_loader::work, this);
+}
+
+Mesh_loader::~Mesh_loader()
+{
+	{
+		// Les fichiers qui n'ont pas encore été commencés ne sont pas lus
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_next_file = m_filenames.size();
+	}
+
+	for(auto& thread : m_threads)
+		thread.join();
+}
+
+void Mesh_loader::work()
+{
+	while(true)
+	{
+		size_t index;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if(m_next_file >= m_filenames.size())
+				return;
+
+			index = m_next_file++;
+		}
+
+		Loaded_mesh loaded_mesh = load(index);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_results.emplace(index, std::move(loaded_mesh));
+		}
+
+		m_loaded.notify_all();
+	}
+}
+
+Loaded_mesh Mesh_loader::load(size_t index) const
+{
+	Loaded_mesh loaded_mesh;
+	loaded_mesh.index	 = index;
+	loaded_mesh.filename = m_filenames[index];
+
+	const std::string& filename = loaded_mesh.filename;
+	std::optional<std::string> texture_path;
+
+	if(!m_process)
+	{
+		// Sans traitement, la Surface_mesh est inutile : les PLY binaires sont projetés en
+		// mémoire et les autres fichiers natifs sont lus directement dans un Mesh_data
+		if(auto mapped_mesh = map_ply(filename))
+		{
+			std::cerr << "[DEBUG] " << filename << " mapped in memory\n";
+			texture_path = mapped_mesh->texture_path;
+			loaded_mesh.mapped.emplace(std::move(*mapped_mesh));
+		}
+		else if(has_native_reader(filename))
+		{
+			if(auto mesh_data = read_mesh_data(filename))
+			{
+				texture_path = mesh_data->texture_path;
+				loaded_mesh.data.emplace(std::move(*mesh_data));
+			}
+		}
+	}
+
+	if(!loaded_mesh.mapped && !loaded_mesh.data)
+	{
+		auto [surface_mesh, mesh_texture_path] = import_surface_mesh(filename);
+
+		if(!mesh_texture_path.empty())
+			texture_path = mesh_texture_path;
+
+		if(m_process)
+		{
+			m_process(index, surface_mesh);
+			loaded_mesh.surface_mesh.emplace(std::move(surface_mesh));
+		}
+		else
+		{
+			loaded_mesh.data.emplace(to_mesh_data(surface_mesh, mesh_texture_path));
+		}
+	}
+
+	if(m_optimize)
+	{
+		// L'optimisation réordonne les index et les sommets : il faut une copie modifiable
+		if(loaded_mesh.mapped)
+		{
+			loaded_mesh.data.emplace(to_mesh_data(*loaded_mesh.mapped));
+			loaded_mesh.mapped.reset();
+		}
+		else if(loaded_mesh.surface_mesh)
+		{
+			loaded_mesh.data.emplace(
+				to_mesh_data(*loaded_mesh.surface_mesh, texture_path.value_or(std::string())));
+			loaded_mesh.surface_mesh.reset();
+		}
+
+		if(loaded_mesh.data)
+		{
+			auto [acmr_before, acmr_after] = optimize_mesh_data(*loaded_mesh.data);
+			std::clog << "[STATUS] " << filename << " ACMR: " << acmr_before << " -> "
+					  << acmr_after << "\n";
+		}
+	}
+
+	// Le décodage de l'image (jpeg, png, ...) est fait ici plutôt que dans QGLMesh::allocate
+	if(texture_path && !texture_path->empty())
+		loaded_mesh.texture = read_texture_image(*texture_path);
+
+	std::cerr << "[DEBUG] " << filename << " loaded\n";
+
+	return loaded_mesh;
+}
+
+std::optional<Loaded_mesh> Mesh_loader::try_pop()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto result = m_results.find(m_next_result);
+
+	if(result == m_results.end())
+		return std::nullopt;
+
+	Loaded_mesh loaded_mesh = std::move(result->second);
+	m_results.erase(result);
+	++m_next_result;
+
+	return loaded_mesh;
+}
+
+std::optional<Loaded_mesh> Mesh_loader::pop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if(m_next_result >= m_filenames.size())
+		return std::nullopt;
+
+	m_loaded.wait(lock, [this] { return m_results.count(m_next_result) > 0; });
+
+	auto result = m_results.find(m_next_result);
+
+	Loaded_mesh loaded_mesh = std::move(result->second);
+	m_results.erase(result);
+	++m_next_result;
+
+	return loaded_mesh;
+}
+
+bool Mesh_loader::finished() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_next_result >= m_filenames.size();
+}
+
+size_t Mesh_loader::size() const
+{
+	return m_filenames.size();
+}
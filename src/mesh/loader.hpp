@@ -0,0 +1,95 @@
+#ifndef MESH_LOADER_HPP
+#define MESH_LOADER_HPP
+
+// PROJECT
+
+#include "../instance/Surface_mesh.hpp"
+#include "data.hpp"
+#include "mapping.hpp"
+
+// QT5
+
+#include <QImage>
+
+// STD
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Maillage chargé par un Mesh_loader, prêt à être envoyé au GPU
+struct Loaded_mesh
+{
+	size_t index = 0; // position du fichier dans la liste donnée au Mesh_loader
+	std::string filename;
+
+	// Un seul des trois est défini : 'mapped' pour les PLY binaires projetés en mémoire,
+	// 'surface_mesh' quand un traitement a été appliqué (envoyée au GPU sans Mesh_data)
+	std::optional<Mesh_data> data;
+	std::optional<Mapped_mesh> mapped;
+	std::optional<Surface_mesh> surface_mesh;
+
+	// Texture déjà décodée (cf. read_texture_image), nulle si le maillage n'en a pas
+	QImage texture;
+};
+
+// Charge une liste de fichiers en parallèle : chaque thread lit un fichier, le convertit en
+// Mesh_data (ou le projette en mémoire, cf. map_ply, ou garde la Surface_mesh traitée) et décode
+// sa texture. Les maillages sont
+// rendus dans l'ordre de la liste par try_pop/pop, l'envoi au GPU reste à la charge du thread
+// qui possède le contexte OpenGL.
+class Mesh_loader
+{
+  public:
+	// Traitement appliqué par le thread de chargement sur la Surface_mesh d'un fichier avant sa
+	// conversion (ex: coloration), 'index' est la position du fichier dans la liste. Quand un
+	// traitement est donné, les fichiers ne sont jamais projetés en mémoire.
+	using Surface_mesh_function = std::function<void(size_t index, Surface_mesh& mesh)>;
+
+	// Si 'optimize' est vrai, les maillages sont toujours rendus sous forme de Mesh_data dont
+	// l'ordre des index est optimisé pour le cache des sommets du GPU (cf. optimize_mesh_data).
+	// 'nb_threads' = 0 utilise number_of_threads() (cf. parallel.hpp), borné par le nombre de fichiers
+	explicit Mesh_loader(std::vector<std::string> filenames, Surface_mesh_function process = {},
+						 bool optimize = false, unsigned int nb_threads = 0);
+
+	// Attend la fin des threads (les fichiers en cours de lecture sont terminés)
+	~Mesh_loader();
+
+	Mesh_loader(const Mesh_loader&) = delete;
+	Mesh_loader& operator=(const Mesh_loader&) = delete;
+
+	// Renvoie le maillage suivant s'il est déjà chargé, sans bloquer
+	std::optional<Loaded_mesh> try_pop();
+
+	// Attend le maillage suivant, renvoie std::nullopt quand tous les maillages ont été rendus
+	std::optional<Loaded_mesh> pop();
+
+	// Vrai quand tous les maillages ont été rendus par try_pop/pop
+	bool finished() const;
+
+	size_t size() const;
+
+  protected:
+	void work();
+	Loaded_mesh load(size_t index) const;
+
+	std::vector<std::string> m_filenames;
+	Surface_mesh_function m_process;
+	bool m_optimize;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_loaded;
+
+	size_t m_next_file	 = 0; // prochain fichier à lire par un thread
+	size_t m_next_result = 0; // prochain maillage à rendre
+	std::map<size_t, Loaded_mesh> m_results;
+
+	std::vector<std::thread> m_threads;
+};
+
+#endif // MESH_LOADER_HPP
@@ -0,0 +1,38 @@
+#include "location.hpp"
+
+// CGAL
+
+#include <CGAL/boost/graph/iterator.h>
+
+// STD
+
+#include <limits>
+
+SM_face_locator::SM_face_locator(const Surface_mesh& mesh) : m_mesh(mesh)
+{
+	m_tree.insert(mesh.faces().begin(), mesh.faces().end(), mesh);
+	m_tree.build();
+
+	// Sans cette structure (un kd-tree sur des points des triangles) la première requête la
+	// construirait, ce qui n'est pas possible depuis plusieurs threads
+	m_tree.accelerate_distance_queries();
+}
+
+Face_location SM_face_locator::locate(const Kernel::Point_3& point) const
+{
+	if(m_tree.empty())
+		return {Surface_mesh::null_face(), {1, 0, 0}, std::numeric_limits<double>::infinity()};
+
+	auto [closest_point, face] = m_tree.closest_point_and_primitive(point);
+
+	auto v_it = CGAL::vertices_around_face(m_mesh.halfedge(face), m_mesh).begin();
+
+	const auto& a = m_mesh.point(*v_it);
+	++v_it;
+	const auto& b = m_mesh.point(*v_it);
+	++v_it;
+	const auto& c = m_mesh.point(*v_it);
+
+	return {face, barycentric_coordinates(a, b, c, point),
+			CGAL::squared_distance(point, closest_point)};
+}
@@ -0,0 +1,82 @@
+#ifndef MESH_LOCATION_HPP
+#define MESH_LOCATION_HPP
+
+// PROJECT
+
+#include "../instance/Surface_mesh_AABB_tree.hpp"
+
+// STD
+
+#include <array>
+
+// Localisation d'un point sur un maillage triangulé
+// - face             : triangle le plus proche (null_face() si le maillage n'a pas de faces)
+// - coordinates      : coordonnées barycentriques de la projection orthogonale du point sur le
+//                      plan du triangle, dans l'ordre de vertices_around_face(halfedge(face))
+// - squared_distance : distance au carré entre le point et le triangle
+struct Face_location
+{
+	Surface_mesh::Face_index face;
+	std::array<double, 3> coordinates;
+	double squared_distance;
+};
+
+// Coordonnées barycentriques de la projection orthogonale de 'p' sur le plan du triangle (a, b, c)
+// Un triangle dégénéré renvoie {1, 0, 0}.
+inline std::array<double, 3> barycentric_coordinates(const Kernel::Point_3& a,
+													 const Kernel::Point_3& b,
+													 const Kernel::Point_3& c,
+													 const Kernel::Point_3& p)
+{
+	Kernel::Vector_3 ab = b - a;
+	Kernel::Vector_3 ac = c - a;
+	Kernel::Vector_3 ap = p - a;
+
+	double d00 = ab * ab;
+	double d01 = ab * ac;
+	double d11 = ac * ac;
+	double d20 = ap * ab;
+	double d21 = ap * ac;
+
+	double denominator = d00 * d11 - d01 * d01;
+
+	if(denominator == 0)
+		return {1, 0, 0};
+
+	double v = (d11 * d20 - d01 * d21) / denominator;
+	double w = (d00 * d21 - d01 * d20) / denominator;
+
+	return {1 - v - w, v, w};
+}
+
+// Vrai si la projection orthogonale se trouve dans le triangle (toutes les coordonnées
+// barycentriques sont positives, à 'tolerance' près). Remplace l'intersection entre le triangle
+// et la droite perpendiculaire passant par le point.
+inline bool is_projected_inside_triangle(const std::array<double, 3>& coordinates,
+										 double tolerance = 1e-9)
+{
+	return coordinates[0] >= -tolerance && coordinates[1] >= -tolerance &&
+		   coordinates[2] >= -tolerance;
+}
+
+// Index de localisation sur les faces d'un maillage (AABB_tree de CGAL) : 'locate' renvoie le
+// triangle le plus proche d'un point en une requête, sans se limiter au voisinage d'un sommet.
+// L'arbre et sa structure d'accélération sont construits par le constructeur : les requêtes
+// peuvent ensuite être faites depuis plusieurs threads.
+// Precondition : le maillage est triangulé, il doit survivre à l'index et ne pas être modifié.
+class SM_face_locator
+{
+  public:
+	explicit SM_face_locator(const Surface_mesh& mesh);
+
+	SM_face_locator(const SM_face_locator&) = delete;
+	SM_face_locator& operator=(const SM_face_locator&) = delete;
+
+	Face_location locate(const Kernel::Point_3& point) const;
+
+  protected:
+	const Surface_mesh& m_mesh;
+	SM_AABB_tree m_tree;
+};
+
+#endif // MESH_LOCATION_HPP
@@ -0,0 +1,272 @@
+#include "mapping.hpp"
+
+// PROJECT
+
+#include "parallel.hpp"
+
+// STD
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+Mapped_file::Mapped_file(const std::string& filename)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+							  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if(file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER size;
+
+	if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if(!mapping)
+	{
+		CloseHandle(file);
+		return;
+	}
+
+	m_data	  = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	m_size	  = static_cast<size_t>(size.QuadPart);
+	m_file	  = file;
+	m_mapping = mapping;
+
+	if(!m_data)
+		close();
+#else
+	int file = ::open(filename.c_str(), O_RDONLY);
+
+	if(file < 0)
+		return;
+
+	struct stat status;
+
+	if(fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		::close(file);
+		return;
+	}
+
+	void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+	// Le fichier peut être fermé, la projection reste valide jusqu'à munmap
+	::close(file);
+
+	if(data == MAP_FAILED)
+		return;
+
+	// Les blocs de sommets et de faces sont parcourus dans l'ordre
+	madvise(data, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+
+	m_data = static_cast<const char*>(data);
+	m_size = static_cast<size_t>(status.st_size);
+#endif
+}
+
+Mapped_file::~Mapped_file()
+{
+	close();
+}
+
+Mapped_file::Mapped_file(Mapped_file&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+Mapped_file& Mapped_file::operator=(Mapped_file&& other) noexcept
+{
+	if(this != &other)
+	{
+		close();
+
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+#ifdef _WIN32
+		std::swap(m_file, other.m_file);
+		std::swap(m_mapping, other.m_mapping);
+#endif
+	}
+
+	return *this;
+}
+
+void Mapped_file::close()
+{
+#ifdef _WIN32
+	if(m_data)
+		UnmapViewOfFile(m_data);
+	if(m_mapping)
+		CloseHandle(m_mapping);
+	if(m_file)
+		CloseHandle(m_file);
+
+	m_file	  = nullptr;
+	m_mapping = nullptr;
+#else
+	if(m_data)
+		munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+}
+
+bool Mapped_file::is_open() const
+{
+	return m_data != nullptr;
+}
+
+const char* Mapped_file::data() const
+{
+	return m_data;
+}
+
+size_t Mapped_file::size() const
+{
+	return m_size;
+}
+
+bool Mapped_attribute::empty() const
+{
+	return data == nullptr || components == 0;
+}
+
+size_t Mapped_attribute::offset(const char* block) const
+{
+	return static_cast<size_t>(data - block);
+}
+
+std::array<float, 4> Mapped_attribute::operator[](size_t i) const
+{
+	std::array<float, 4> value = {0, 0, 0, 1};
+	const char* element		   = data + i * stride;
+
+	if(type == Type::Float32)
+	{
+		std::memcpy(value.data(), element, components * sizeof(float));
+	}
+	else
+	{
+		for(unsigned c = 0; c < components; ++c)
+			value[c] = static_cast<unsigned char>(element[c]) / 255.0f;
+	}
+
+	return value;
+}
+
+void copy_triangles(const Mapped_mesh& mesh, unsigned int* destination)
+{
+	// Chaque face commence par son nombre de sommets (1 octet) suivi de 3 index de 4 octets
+	parallel_for_chunks(mesh.number_of_faces, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; ++i)
+			std::memcpy(destination + 3 * i, mesh.face_data + i * mesh.face_stride + 1,
+						3 * sizeof(unsigned int));
+	});
+}
+
+std::array<Mesh_data::vec_3f, 2> bounding_box(const Mapped_mesh& mesh)
+{
+	const float max = std::numeric_limits<float>::max();
+
+	std::array<Mesh_data::vec_3f, 2> box = {Mesh_data::vec_3f{max, max, max},
+											Mesh_data::vec_3f{-max, -max, -max}};
+	std::mutex box_mutex;
+
+	// Les positions sont toujours des flottants (cf. map_ply)
+	parallel_for_chunks(mesh.number_of_vertices, [&](size_t begin, size_t end) {
+		std::array<Mesh_data::vec_3f, 2> chunk_box = {Mesh_data::vec_3f{max, max, max},
+													  Mesh_data::vec_3f{-max, -max, -max}};
+
+		for(size_t i = begin; i < end; ++i)
+		{
+			float position[3];
+			std::memcpy(position, mesh.positions.data + i * mesh.positions.stride,
+						sizeof(position));
+
+			for(size_t c = 0; c < 3; ++c)
+			{
+				chunk_box[0][c] = std::min(chunk_box[0][c], position[c]);
+				chunk_box[1][c] = std::max(chunk_box[1][c], position[c]);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(box_mutex);
+
+		for(size_t c = 0; c < 3; ++c)
+		{
+			box[0][c] = std::min(box[0][c], chunk_box[0][c]);
+			box[1][c] = std::max(box[1][c], chunk_box[1][c]);
+		}
+	});
+
+	return box;
+}
+
+Mesh_data to_mesh_data(const Mapped_mesh& mesh)
+{
+	Mesh_data mesh_data;
+
+	auto& positions = mesh_data.positions.emplace(mesh.number_of_vertices);
+
+	if(!mesh.normals.empty())
+		mesh_data.normals.emplace(mesh.number_of_vertices);
+
+	if(!mesh.colors.empty())
+		mesh_data.colors.emplace(mesh.number_of_vertices);
+
+	if(!mesh.texcoords.empty())
+		mesh_data.texcoords.emplace(mesh.number_of_vertices);
+
+	parallel_for_chunks(mesh.number_of_vertices, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; ++i)
+		{
+			auto position = mesh.positions[i];
+			positions[i]  = {position[0], position[1], position[2]};
+
+			if(mesh_data.normals)
+			{
+				auto normal				= mesh.normals[i];
+				(*mesh_data.normals)[i] = {normal[0], normal[1], normal[2]};
+			}
+
+			if(mesh_data.colors)
+				(*mesh_data.colors)[i] = mesh.colors[i];
+
+			if(mesh_data.texcoords)
+			{
+				auto texcoord			  = mesh.texcoords[i];
+				(*mesh_data.texcoords)[i] = {texcoord[0], texcoord[1]};
+			}
+		}
+	});
+
+	auto& faces = mesh_data.triangulated_faces.emplace(mesh.number_of_faces);
+
+	if(!faces.empty())
+		copy_triangles(mesh, faces.front().data());
+
+	mesh_data.texture_path = mesh.texture_path;
+
+	return mesh_data;
+}
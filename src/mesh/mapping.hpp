@@ -0,0 +1,105 @@
+#ifndef MESH_MAPPING_HPP
+#define MESH_MAPPING_HPP
+
+// PROJECT
+
+#include "data.hpp"
+
+// STD
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+
+// Fichier projeté en mémoire en lecture seule (mmap sous unix, MapViewOfFile sous windows). Les
+// pages ne sont lues sur le disque qu'au premier accès.
+class Mapped_file
+{
+  public:
+	Mapped_file() = default;
+	explicit Mapped_file(const std::string& filename);
+	~Mapped_file();
+
+	Mapped_file(Mapped_file&& other) noexcept;
+	Mapped_file& operator=(Mapped_file&& other) noexcept;
+
+	Mapped_file(const Mapped_file&) = delete;
+	Mapped_file& operator=(const Mapped_file&) = delete;
+
+	bool is_open() const;
+	const char* data() const;
+	size_t size() const;
+
+  protected:
+	void close();
+
+	const char* m_data = nullptr;
+	size_t m_size	   = 0;
+
+#ifdef _WIN32
+	void* m_file	= nullptr;
+	void* m_mapping = nullptr;
+#endif
+};
+
+// Vue (à la manière de std::span) sur un attribut de sommet rangé dans un bloc entrelacé :
+// le i-ème élément commence à data + i * stride et contient 'components' valeurs de type 'type'.
+struct Mapped_attribute
+{
+	enum class Type
+	{
+		Float32,
+		Uint8
+	};
+
+	const char* data	= nullptr;
+	size_t stride		= 0;
+	size_t count		= 0;
+	unsigned components = 0;
+	Type type			= Type::Float32;
+
+	bool empty() const;
+
+	// Décalage de l'attribut par rapport au début du bloc
+	size_t offset(const char* block) const;
+
+	// Lit la i-ème valeur (les entiers sont ramenés dans [0, 1] comme le fait OpenGL pour un
+	// attribut normalisé, les composantes absentes valent 0 sauf la quatrième qui vaut 1)
+	std::array<float, 4> operator[](size_t i) const;
+};
+
+// Maillage d'un PLY binaire projeté en mémoire : les attributs pointent directement dans le bloc
+// des sommets du fichier, qui peut être envoyé tel quel au GPU (cf. QGLMesh::allocate).
+struct Mapped_mesh
+{
+	Mapped_file file;
+
+	const char* vertex_data	  = nullptr;
+	size_t vertex_stride	  = 0;
+	size_t number_of_vertices = 0;
+
+	Mapped_attribute positions;
+	Mapped_attribute normals;
+	Mapped_attribute colors;
+	Mapped_attribute texcoords;
+
+	// Faces stockées comme (uchar 3, index a, b, c) : les index ne sont pas contigus
+	const char* face_data  = nullptr;
+	size_t face_stride	   = 0;
+	size_t number_of_faces = 0;
+
+	std::optional<std::string> texture_path;
+};
+
+// Recopie les index des triangles dans 'destination' (3 * number_of_faces entiers), en parallèle.
+// 'destination' peut être la mémoire d'un buffer OpenGL projeté (glMapBuffer).
+void copy_triangles(const Mapped_mesh& mesh, unsigned int* destination);
+
+// Boite englobante des positions (min, max)
+std::array<Mesh_data::vec_3f, 2> bounding_box(const Mapped_mesh& mesh);
+
+// Copie les attributs dans un Mesh_data (pour les traitements qui ont besoin d'une Surface_mesh)
+Mesh_data to_mesh_data(const Mapped_mesh& mesh);
+
+#endif // MESH_MAPPING_HPP
@@ -2,6 +2,11 @@
 #define MESH_MARKING_HPP
 
 #include "../instance/Surface_mesh_kd_tree.hpp"
+#include "adjacency.hpp"
+#include "flat.hpp"
+#include "result.hpp"
+#include "search.hpp"
+#include "selection.hpp"
 
 // Cette enumération est utilisée pour annoter les sommets d'un maillage
 // - Close   -> Sommet proche d'un autre maillage
@@ -19,9 +24,30 @@ enum class Vertex_mark : unsigned char
 using SM_marking_map =
 	Surface_mesh::Property_map<Surface_mesh::Vertex_index, Vertex_mark>;
 
-// Renvoie la carte d'annotation associée à un maillage (assertion failure si la carte n'existe pas)
+// Renvoie la carte d'annotation associée à un maillage
+// Precondition : le maillage doit avoir été annoté (assertion failure sinon, cf. try_get_marking_map)
 SM_marking_map get_marking_map(const Surface_mesh& mesh);
 
+// Comme get_marking_map mais renvoie une erreur si le maillage n'a pas été annoté
+Result<SM_marking_map> try_get_marking_map(const Surface_mesh& mesh);
+
+// Recopie les annotations dans un tableau d'octets dans l'ordre de 'adjacency.vertices', pour que
+// les parcours de voisinage ne fassent plus de recherche dans la carte de CGAL
+std::vector<Vertex_mark> packed_marks(const Surface_mesh& mesh, const Vertex_adjacency& adjacency);
+std::vector<Vertex_mark> packed_marks(const SM_marking_map& marking_map,
+									  const Vertex_adjacency& adjacency);
+
+// Vrai si au moins un voisin du sommet dense i a l'annotation 'mark' (adjacence au format CSR)
+bool has_neighbor_marked(const std::vector<Vertex_mark>& marks,
+						 const std::vector<unsigned int>& offsets,
+						 const std::vector<unsigned int>& neighbors, size_t i, Vertex_mark mark);
+
+// Annotation d'un point en fonction de sa distance à l'arbre (Close si <= threshold, Distant si
+// > threshold + epsilon, Limit sinon). La distance exacte n'est jamais calculée : seules des
+// requêtes bornées (sphères de rayon threshold + epsilon puis threshold) sont effectuées.
+Vertex_mark distance_mark(const SM_kd_tree& tree, const Kernel::Point_3& point,
+						  double threshold, double epsilon = 0);
+
 // Créée et renvoie la carte d'annotation en fonction des distances entre 2 maillages (close / distant)
 SM_marking_map mark_regions(Surface_mesh& M1, const SM_kd_tree& M2_tree,
 							double threshold, double epsilon = 0);
@@ -29,7 +55,14 @@ SM_marking_map mark_regions(Surface_mesh& M1, const Surface_mesh& M2,
 							double threshold, double epsilon = 0);
 
 // Rajoute les une annotation sur sommets limites d'un maillages qui à déja été marqué (close / distant)
+// Les sommets sont classés en parallèle sur l'adjacence CSR 'adjacency' (construite à la volée
+// si elle n'est pas fournie).
 SM_marking_map mark_limits(const Surface_mesh& mesh);
+SM_marking_map mark_limits(const Surface_mesh& mesh, const Vertex_adjacency& adjacency);
+// Travaille sur une carte déjà obtenue (ex: par try_get_marking_map) sans la rechercher à nouveau
+SM_marking_map mark_limits(SM_marking_map marking_map, const Vertex_adjacency& adjacency);
+// Renvoie une erreur (sans rien modifier) si le maillage n'a pas été annoté
+Result<SM_marking_map> try_mark_limits(const Surface_mesh& mesh, const Vertex_adjacency& adjacency);
 
 // Change limits value with mark on mesh
 SM_marking_map mark_limits_with(const Surface_mesh& mesh, const Vertex_mark& mark);
@@ -42,9 +75,32 @@ SM_marking_map mark_delimited_regions(Surface_mesh& M1,
 									  double threshold, double epsilon = 0);
 SM_marking_map mark_delimited_regions(Surface_mesh& M1, const Surface_mesh& M2,
 									  double threshold, double epsilon = 0);
-
+// Réutilise l'arbre de M2 conservé dans 'kd_trees'
+SM_marking_map mark_delimited_regions(Surface_mesh& M1, const Surface_mesh& M2,
+									  SM_kd_tree_cache& kd_trees, double threshold,
+									  double epsilon = 0);
+// Réutilise en plus l'adjacence de M1
+SM_marking_map mark_delimited_regions(Surface_mesh& M1, const Vertex_adjacency& M1_adjacency,
+									  const Surface_mesh& M2, SM_kd_tree_cache& kd_trees,
+									  double threshold, double epsilon = 0);
+// Comme ci-dessus mais renvoie une erreur (sans construire d'arbre ni modifier M1) si M2 est vide
+Result<SM_marking_map> try_mark_delimited_regions(Surface_mesh& M1,
+												  const Vertex_adjacency& M1_adjacency,
+												  const Surface_mesh& M2,
+												  SM_kd_tree_cache& kd_trees, double threshold,
+												  double epsilon = 0);
+
+
+// Variantes de l'annotation sur la vue compacte d'un maillage (cf. flat.hpp), les annotations sont
+// rangées dans 'M1.marks' (utilisez sync_surface_mesh pour les recopier dans le Surface_mesh).
+const std::vector<Vertex_mark>& mark_regions(Flat_mesh& M1, const SM_kd_tree& M2_tree,
+											 double threshold, double epsilon = 0);
+const std::vector<Vertex_mark>& mark_limits(Flat_mesh& mesh);
+const std::vector<Vertex_mark>& mark_delimited_regions(Flat_mesh& M1, const SM_kd_tree& M2_tree,
+													   double threshold, double epsilon = 0);
 
 // Renvoie les index des sommets qui ont une annotation 'mark' associée
+// Les sélections sont faites en parallèle et conservent l'ordre des sommets de 'mesh_vertices'.
 template <class VertexRange>
 auto marked_vertices(const Surface_mesh& mesh, const VertexRange& mesh_vertices,
 					 const Vertex_mark mark);
@@ -58,8 +114,17 @@ auto marked_vertices(const Surface_mesh& mesh, const VertexRange& mesh_vertices,
                      const Vertex_mark mark, const Vertex_mark mark_neighbor);
 auto marked_vertices(const Surface_mesh& mesh,
                      const Vertex_mark mark, const Vertex_mark mark_neighbor);
+// Parcours des voisins sur l'adjacence CSR de 'mesh' (cf. adjacency.hpp)
+auto marked_vertices(const Surface_mesh& mesh, const Vertex_adjacency& adjacency,
+                     const Vertex_mark mark, const Vertex_mark mark_neighbor);
+
+// Comme marked_vertices mais le résultat est une sélection (cf. selection.hpp) : aucune liste
+// d'index n'est construite et les sélections peuvent être combinées (&, |, -)
+Vertex_selection marked_selection(const Surface_mesh& mesh, const Vertex_mark mark);
+Vertex_selection marked_selection(const Surface_mesh& mesh, const Vertex_adjacency& adjacency,
+								  const Vertex_mark mark, const Vertex_mark mark_neighbor);
 
-// Surcharge de marked_vertices pour être plus simple d'utilisation
+// Surcharges de marked_selection pour être plus simple d'utilisation
 auto none_vertices(const Surface_mesh& mesh);
 
 auto close_vertices(const Surface_mesh& mesh);
@@ -3,8 +3,13 @@
 
 #include "marking.hpp"
 
+#include "indexing.hpp"
+#include "parallel.hpp"
+
 // STD
+#include <cassert>
 #include <cmath>
+#include <vector>
 
 // CGAL
 #include <CGAL/boost/graph/iterator.h>
@@ -19,6 +24,61 @@ SM_marking_map get_marking_map(const Surface_mesh& mesh)
     return marking_map;
 }
 
+Result<SM_marking_map> try_get_marking_map(const Surface_mesh& mesh)
+{
+    auto [marking_map, marking_map_exist] =
+        mesh.property_map<Surface_mesh::Vertex_index, Vertex_mark>("v:mark");
+
+    if(!marking_map_exist)
+        return Error{"mesh vertices are not marked (missing v:mark map)"};
+
+    return marking_map;
+}
+
+std::vector<Vertex_mark> packed_marks(const Surface_mesh& mesh, const Vertex_adjacency& adjacency)
+{
+    return packed_marks(get_marking_map(mesh), adjacency);
+}
+
+std::vector<Vertex_mark> packed_marks(const SM_marking_map& marking_map,
+                                      const Vertex_adjacency& adjacency)
+{
+    std::vector<Vertex_mark> marks(adjacency.size());
+
+    parallel_for(marks.size(), [&](std::size_t i) {
+        marks[i] = marking_map[adjacency.vertices[i]];
+    });
+
+    return marks;
+}
+
+bool has_neighbor_marked(const std::vector<Vertex_mark>& marks,
+                         const std::vector<unsigned int>& offsets,
+                         const std::vector<unsigned int>& neighbors, size_t i, Vertex_mark mark)
+{
+    for(auto n = offsets[i]; n < offsets[i + 1]; ++n)
+    {
+        if(marks[neighbors[n]] == mark)
+            return true;
+    }
+
+    return false;
+}
+
+Vertex_mark distance_mark(const SM_kd_tree& tree, const Kernel::Point_3& point,
+                          double threshold, double epsilon)
+{
+    // La majorité des sommets de couches partiellement superposées sont distants : on teste
+    // d'abord la sphère la plus large qui suffit à les classer.
+    if(!has_vertex_within(tree, point, threshold + epsilon))
+        return Vertex_mark::Distant;
+
+    if(epsilon <= 0 || has_vertex_within(tree, point, threshold))
+        return Vertex_mark::Close;
+
+    return Vertex_mark::Limit;
+}
+
 SM_marking_map mark_regions(Surface_mesh& M1, const SM_kd_tree& M2_tree,
                             double threshold, double epsilon)
 {
@@ -26,26 +86,16 @@ SM_marking_map mark_regions(Surface_mesh& M1, const SM_kd_tree& M2_tree,
         M1.add_property_map<Surface_mesh::Vertex_index, Vertex_mark>(
             "v:mark", Vertex_mark::None);
 
-    for(auto v : M1.vertices())
-    {
-        SM_kd_tree_search search(M2_tree, M1.point(v), 1, 0, true,
-                                 M2_tree.traits().point_property_map());
+    std::vector<Surface_mesh::Vertex_index> vertices(M1.vertices().begin(),
+                                                     M1.vertices().end());
 
-        double distance = std::sqrt(search.begin()->second);
+    prepare_concurrent_queries(M2_tree);
 
-        if(distance > threshold + epsilon)
-        {
-            marking_map[v] = Vertex_mark::Distant;
-        }
-        else if(distance <= threshold)
-        {
-            marking_map[v] = Vertex_mark::Close;
-        }
-        else
-        {
-            marking_map[v] = Vertex_mark::Limit;
-        }
-    }
+    // Chaque thread écrit dans des cases distinctes de la carte d'annotation
+    parallel_for(vertices.size(), [&](std::size_t i) {
+        marking_map[vertices[i]] =
+            distance_mark(M2_tree, M1.point(vertices[i]), threshold, epsilon);
+    });
 
     return marking_map;
 }
@@ -59,31 +109,43 @@ SM_marking_map mark_regions(Surface_mesh& M1, const Surface_mesh& M2,
     return mark_regions(M1, M2_tree, threshold, epsilon);
 }
 
-SM_marking_map mark_limits(const Surface_mesh& mesh)
+SM_marking_map mark_limits(const Surface_mesh& mesh, const Vertex_adjacency& adjacency)
 {
-    auto marking_map = get_marking_map(mesh);
+    return mark_limits(get_marking_map(mesh), adjacency);
+}
 
-    for(auto v : mesh.vertices())
-    {
-        if(marking_map[v] == Vertex_mark::Close)
-        {
-            auto around_vertices =
-                CGAL::vertices_around_target(mesh.halfedge(v), mesh);
+SM_marking_map mark_limits(SM_marking_map marking_map, const Vertex_adjacency& adjacency)
+{
+    // Les threads lisent les annotations d'origine et n'écrivent dans la carte
+    // que les sommets qu'ils classent
+    auto marks = packed_marks(marking_map, adjacency);
 
-            for(auto i : around_vertices)
-            {
-                if(marking_map[i] == Vertex_mark::Distant)
-                {
-                    marking_map[v] = Vertex_mark::Limit;
-                    break;
-                }
-            }
-        }
-    }
+    parallel_for(marks.size(), [&](std::size_t i) {
+        if(marks[i] == Vertex_mark::Close &&
+           has_neighbor_marked(marks, adjacency.offsets, adjacency.neighbors, i,
+                               Vertex_mark::Distant))
+            marking_map[adjacency.vertices[i]] = Vertex_mark::Limit;
+    });
 
     return marking_map;
 }
 
+Result<SM_marking_map> try_mark_limits(const Surface_mesh& mesh,
+                                       const Vertex_adjacency& adjacency)
+{
+    auto marking_map = try_get_marking_map(mesh);
+
+    if(!marking_map)
+        return marking_map;
+
+    return mark_limits(*marking_map, adjacency);
+}
+
+SM_marking_map mark_limits(const Surface_mesh& mesh)
+{
+    return mark_limits(mesh, make_vertex_adjacency(mesh));
+}
+
 SM_marking_map mark_limits_with(const Surface_mesh& mesh, const Vertex_mark& mark)
 {
     auto marking_map = get_marking_map(mesh);
@@ -115,77 +177,186 @@ SM_marking_map mark_delimited_regions(Surface_mesh& M1, const Surface_mesh& M2,
     return mark_limits(M1);
 }
 
+SM_marking_map mark_delimited_regions(Surface_mesh& M1, const Surface_mesh& M2,
+                                      SM_kd_tree_cache& kd_trees, double threshold,
+                                      double epsilon)
+{
+    return mark_delimited_regions(M1, kd_trees.tree(M2), threshold, epsilon);
+}
+
+SM_marking_map mark_delimited_regions(Surface_mesh& M1, const Vertex_adjacency& M1_adjacency,
+                                      const Surface_mesh& M2, SM_kd_tree_cache& kd_trees,
+                                      double threshold, double epsilon)
+{
+    // mark_regions crée la carte de M1 : mark_limits la reçoit directement
+    return mark_limits(mark_regions(M1, kd_trees.tree(M2), threshold, epsilon), M1_adjacency);
+}
+
+Result<SM_marking_map> try_mark_delimited_regions(Surface_mesh& M1,
+                                                  const Vertex_adjacency& M1_adjacency,
+                                                  const Surface_mesh& M2,
+                                                  SM_kd_tree_cache& kd_trees, double threshold,
+                                                  double epsilon)
+{
+    if(M2.number_of_vertices() == 0)
+        return Error{"empty mesh"};
+
+    return mark_delimited_regions(M1, M1_adjacency, M2, kd_trees, threshold, epsilon);
+}
+
+const std::vector<Vertex_mark>& mark_regions(Flat_mesh& M1, const SM_kd_tree& M2_tree,
+                                             double threshold, double epsilon)
+{
+    M1.marks.resize(M1.size());
+
+    prepare_concurrent_queries(M2_tree);
+
+    parallel_for(M1.size(), [&](std::size_t i) {
+        M1.marks[i] = distance_mark(M2_tree, M1.point(i), threshold, epsilon);
+    });
+
+    return M1.marks;
+}
+
+const std::vector<Vertex_mark>& mark_limits(Flat_mesh& mesh)
+{
+    assert(mesh.marks.size() == mesh.size());
+
+    // Les threads lisent les annotations d'origine et écrivent dans une copie
+    std::vector<Vertex_mark> marks = mesh.marks;
+
+    parallel_for(mesh.size(), [&](std::size_t i) {
+        if(mesh.marks[i] == Vertex_mark::Close &&
+           has_neighbor_marked(mesh.marks, mesh.neighbor_offsets, mesh.neighbors, i,
+                               Vertex_mark::Distant))
+            marks[i] = Vertex_mark::Limit;
+    });
+
+    mesh.marks.swap(marks);
+
+    return mesh.marks;
+}
+
+const std::vector<Vertex_mark>& mark_delimited_regions(Flat_mesh& M1, const SM_kd_tree& M2_tree,
+                                                       double threshold, double epsilon)
+{
+    mark_regions(M1, M2_tree, threshold, epsilon);
+    return mark_limits(M1);
+}
+
 template <class VertexRange>
 auto marked_vertices(const Surface_mesh& mesh, const VertexRange& mesh_vertices,
                      const Vertex_mark mark)
 {
-    std::vector<Surface_mesh::Vertex_index> result;
+    std::vector<Surface_mesh::Vertex_index> vertices(mesh_vertices.begin(),
+                                                     mesh_vertices.end());
     auto marking_map = get_marking_map(mesh);
 
-    std::copy_if(mesh_vertices.begin(), mesh_vertices.end(),
-                 std::back_inserter(result),
-                 [&, mark](auto v) { return marking_map[v] == mark; });
-
-    return result;
+    return parallel_select(
+        vertices.size(),
+        [&](std::size_t i) { return marking_map[vertices[i]] == mark; },
+        [&](std::size_t i) { return vertices[i]; });
 }
 
-template <class VertexRange>
 auto marked_vertices(const Surface_mesh& mesh, const Vertex_mark& mark)
 {
     return marked_vertices(mesh, mesh.vertices(), mark);
 }
 
+Vertex_selection marked_selection(const Surface_mesh& mesh, const Vertex_mark mark)
+{
+    auto marking_map = get_marking_map(mesh);
+
+    return select_vertices(mesh, [&](Surface_mesh::Vertex_index v) {
+        return marking_map[v] == mark;
+    });
+}
+
+Vertex_selection marked_selection(const Surface_mesh& mesh, const Vertex_adjacency& adjacency,
+                                  const Vertex_mark mark, const Vertex_mark mark_neighbor)
+{
+    auto marks = packed_marks(mesh, adjacency);
+
+    Dense_vertex_index dense_index(mesh);
+
+    return select_vertices(mesh, [&](Surface_mesh::Vertex_index v) {
+        auto i = dense_index[v];
+
+        return marks[i] == mark &&
+               has_neighbor_marked(marks, adjacency.offsets, adjacency.neighbors, i,
+                                   mark_neighbor);
+    });
+}
+
 auto none_vertices(const Surface_mesh& mesh)
 {
-    return marked_vertices(mesh, mesh.vertices(), Vertex_mark::None);
+    return marked_selection(mesh, Vertex_mark::None);
 }
 
 auto close_vertices(const Surface_mesh& mesh)
 {
-    return marked_vertices(mesh, mesh.vertices(), Vertex_mark::Close);
+    return marked_selection(mesh, Vertex_mark::Close);
 }
 
 auto limit_vertices(const Surface_mesh& mesh)
 {
-    return marked_vertices(mesh, mesh.vertices(), Vertex_mark::Limit);
+    return marked_selection(mesh, Vertex_mark::Limit);
 }
 
 auto distant_vertices(const Surface_mesh& mesh)
 {
-    return marked_vertices(mesh, mesh.vertices(), Vertex_mark::Distant);
+    return marked_selection(mesh, Vertex_mark::Distant);
 }
 
 template <class VertexRange>
 auto marked_vertices(const Surface_mesh& mesh, const VertexRange& mesh_vertices,
                      const Vertex_mark mark, const Vertex_mark mark_neighbor)
 {
-    std::vector<Surface_mesh::Vertex_index> result;
+    std::vector<Surface_mesh::Vertex_index> vertices(mesh_vertices.begin(),
+                                                     mesh_vertices.end());
     auto marking_map = get_marking_map(mesh);
 
-    std::copy_if(mesh_vertices.begin(), mesh_vertices.end(),
-                 std::back_inserter(result), [&, mark](auto v) {
-                     if(marking_map[v] == mark)
-                     {
-                         auto around_vertices = CGAL::vertices_around_target(
-                             mesh.halfedge(v), mesh);
+    // Sous-ensemble quelconque de sommets : les voisins sont parcourus dans
+    // la Surface_mesh (en lecture seule, donc sans synchronisation)
+    return parallel_select(
+        vertices.size(),
+        [&](std::size_t i) {
+            auto v = vertices[i];
 
-                         for(auto i : around_vertices)
-                         {
-                             if(marking_map[i] == mark_neighbor)
-                                 return true;
-                         }
-                     }
+            if(marking_map[v] != mark ||
+               mesh.halfedge(v) == Surface_mesh::null_halfedge())
+                return false;
 
-                     return false;
-                 });
+            for(auto n : CGAL::vertices_around_target(mesh.halfedge(v), mesh))
+            {
+                if(marking_map[n] == mark_neighbor)
+                    return true;
+            }
+
+            return false;
+        },
+        [&](std::size_t i) { return vertices[i]; });
+}
 
-    return result;
+auto marked_vertices(const Surface_mesh& mesh, const Vertex_adjacency& adjacency,
+                     const Vertex_mark mark, const Vertex_mark mark_neighbor)
+{
+    auto marks = packed_marks(mesh, adjacency);
+
+    return parallel_select(
+        marks.size(),
+        [&](std::size_t i) {
+            return marks[i] == mark &&
+                   has_neighbor_marked(marks, adjacency.offsets, adjacency.neighbors,
+                                       i, mark_neighbor);
+        },
+        [&](std::size_t i) { return adjacency.vertices[i]; });
 }
 
 auto marked_vertices(const Surface_mesh& mesh, const Vertex_mark mark,
                      const Vertex_mark mark_neighbor)
 {
-    return marked_vertices(mesh, mesh.vertices(), mark, mark_neighbor);
+    return marked_vertices(mesh, make_vertex_adjacency(mesh), mark, mark_neighbor);
 }
 
 #endif // MESH_MARKING_INL
\ No newline at end of file
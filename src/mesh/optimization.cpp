@@ -0,0 +1,335 @@
+#include "optimization.hpp"
+
+// STD
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+// Paramètres de l'article de Forsyth
+const float cache_decay_power	= 1.5f;
+const float last_triangle_score = 0.75f;
+const float valence_boost_scale = 2.0f;
+const float valence_boost_power = 0.5f;
+
+// Score d'un sommet : élevé s'il est récent dans le cache et s'il lui reste peu de triangles.
+// Les puissances sont tabulées, ce score étant recalculé pour tout le cache à chaque triangle.
+class Vertex_scoring
+{
+  public:
+	explicit Vertex_scoring(size_t cache_size) : m_cache_scores(cache_size), m_valence_scores(64)
+	{
+		for(size_t i = 0; i < cache_size; ++i)
+		{
+			// Les sommets du dernier triangle ont un score fixe pour ne pas favoriser un ordre
+			// en éventail
+			if(i < 3)
+			{
+				m_cache_scores[i] = last_triangle_score;
+			}
+			else
+			{
+				float scaler	  = 1.0f / static_cast<float>(cache_size - 3);
+				m_cache_scores[i] = std::pow(1.0f - static_cast<float>(i - 3) * scaler,
+											 cache_decay_power);
+			}
+		}
+
+		for(size_t valence = 1; valence < m_valence_scores.size(); ++valence)
+			m_valence_scores[valence] = valence_score(static_cast<unsigned int>(valence));
+	}
+
+	float operator()(int cache_position, unsigned int remaining_triangles) const
+	{
+		if(remaining_triangles == 0)
+			return -1.0f;
+
+		float score = cache_position >= 0 ? m_cache_scores[static_cast<size_t>(cache_position)]
+										  : 0.0f;
+
+		return score + (remaining_triangles < m_valence_scores.size()
+							? m_valence_scores[remaining_triangles]
+							: valence_score(remaining_triangles));
+	}
+
+  protected:
+	static float valence_score(unsigned int remaining_triangles)
+	{
+		return valence_boost_scale *
+			   std::pow(static_cast<float>(remaining_triangles), -valence_boost_power);
+	}
+
+	std::vector<float> m_cache_scores;
+	std::vector<float> m_valence_scores;
+};
+
+} // namespace
+
+double average_cache_miss_ratio(const Triangle_list& triangles, size_t nb_vertices,
+								size_t cache_size)
+{
+	if(triangles.empty())
+		return 0.0;
+
+	// Cache FIFO : un sommet inséré au n-ième défaut est évincé au (n + cache_size)-ième
+	std::vector<size_t> inserted_at(nb_vertices, 0); // 0 = jamais inséré, sinon n + 1
+	size_t misses = 0;
+
+	for(const auto& triangle : triangles)
+	{
+		for(auto v : triangle)
+		{
+			if(inserted_at[v] == 0 || misses - (inserted_at[v] - 1) >= cache_size)
+			{
+				inserted_at[v] = misses + 1;
+				++misses;
+			}
+		}
+	}
+
+	return static_cast<double>(misses) / static_cast<double>(triangles.size());
+}
+
+std::vector<unsigned int> vertex_cache_order(const Triangle_list& triangles, size_t nb_vertices,
+											 size_t cache_size)
+{
+	const unsigned int none = std::numeric_limits<unsigned int>::max();
+
+	size_t nb_triangles = triangles.size();
+
+	cache_size = std::max<size_t>(cache_size, 4);
+
+	// Triangles restants de chaque sommet au format CSR : ceux du sommet v sont
+	// adjacency[offsets[v]] ... adjacency[offsets[v] + remaining[v] - 1]
+	std::vector<unsigned int> remaining(nb_vertices, 0);
+
+	for(const auto& triangle : triangles)
+	{
+		for(auto v : triangle)
+			++remaining[v];
+	}
+
+	std::vector<size_t> offsets(nb_vertices + 1, 0);
+
+	for(size_t v = 0; v < nb_vertices; ++v)
+		offsets[v + 1] = offsets[v] + remaining[v];
+
+	std::vector<unsigned int> adjacency(offsets.back());
+
+	{
+		std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+
+		for(size_t t = 0; t < nb_triangles; ++t)
+		{
+			for(auto v : triangles[t])
+				adjacency[next[v]++] = static_cast<unsigned int>(t);
+		}
+	}
+
+	Vertex_scoring vertex_score(cache_size);
+
+	std::vector<int> cache_position(nb_vertices, -1);
+	std::vector<float> vertex_scores(nb_vertices);
+
+	for(size_t v = 0; v < nb_vertices; ++v)
+		vertex_scores[v] = vertex_score(-1, remaining[v]);
+
+	std::vector<float> triangle_scores(nb_triangles);
+	std::vector<bool> added(nb_triangles, false);
+
+	auto triangle_score = [&](size_t t) {
+		const auto& triangle = triangles[t];
+		return vertex_scores[triangle[0]] + vertex_scores[triangle[1]] +
+			   vertex_scores[triangle[2]];
+	};
+
+	unsigned int best_triangle = none;
+	float best_score		   = -1.0f;
+
+	for(size_t t = 0; t < nb_triangles; ++t)
+	{
+		triangle_scores[t] = triangle_score(t);
+
+		if(triangle_scores[t] > best_score)
+		{
+			best_score	  = triangle_scores[t];
+			best_triangle = static_cast<unsigned int>(t);
+		}
+	}
+
+	std::vector<unsigned int> order;
+	order.reserve(nb_triangles);
+
+	std::vector<unsigned int> cache, new_cache;
+	cache.reserve(cache_size + 3);
+	new_cache.reserve(cache_size + 3);
+
+	// in_new_cache[v] == t si v est un sommet du triangle t (le dernier ajouté)
+	std::vector<unsigned int> in_new_cache(nb_vertices, none);
+
+	size_t next_unadded = 0;
+
+	while(order.size() < nb_triangles)
+	{
+		// Aucun triangle ne touche le cache : reprise au premier triangle restant
+		if(best_triangle == none)
+		{
+			while(added[next_unadded])
+				++next_unadded;
+
+			best_triangle = static_cast<unsigned int>(next_unadded);
+		}
+
+		unsigned int t = best_triangle;
+		added[t]	   = true;
+		order.push_back(t);
+
+		// Le triangle est retiré des listes de ses sommets
+		for(auto v : triangles[t])
+		{
+			auto begin = adjacency.begin() + static_cast<std::ptrdiff_t>(offsets[v]);
+			auto end   = begin + remaining[v];
+
+			std::iter_swap(std::find(begin, end, t), end - 1);
+			--remaining[v];
+		}
+
+		// Cache LRU : les sommets du triangle passent en tête
+		new_cache.clear();
+
+		for(auto v : triangles[t])
+		{
+			if(in_new_cache[v] != t)
+			{
+				in_new_cache[v] = t;
+				new_cache.push_back(v);
+			}
+		}
+
+		for(auto v : cache)
+		{
+			if(in_new_cache[v] != t)
+				new_cache.push_back(v);
+		}
+
+		for(size_t i = 0; i < new_cache.size(); ++i)
+		{
+			unsigned int v	  = new_cache[i];
+			cache_position[v] = i < cache_size ? static_cast<int>(i) : -1;
+			vertex_scores[v]  = vertex_score(cache_position[v], remaining[v]);
+		}
+
+		// Seuls les triangles des sommets dont le score a changé sont mis à jour
+		best_triangle = none;
+		best_score	  = -1.0f;
+
+		for(auto v : new_cache)
+		{
+			for(size_t i = offsets[v]; i < offsets[v] + remaining[v]; ++i)
+			{
+				unsigned int candidate	   = adjacency[i];
+				triangle_scores[candidate] = triangle_score(candidate);
+
+				if(triangle_scores[candidate] > best_score)
+				{
+					best_score	  = triangle_scores[candidate];
+					best_triangle = candidate;
+				}
+			}
+		}
+
+		if(new_cache.size() > cache_size)
+			new_cache.resize(cache_size);
+
+		std::swap(cache, new_cache);
+	}
+
+	return order;
+}
+
+std::vector<unsigned int> vertex_fetch_remap(const Triangle_list& triangles, size_t nb_vertices)
+{
+	const unsigned int none = std::numeric_limits<unsigned int>::max();
+
+	std::vector<unsigned int> remap(nb_vertices, none);
+	unsigned int next = 0;
+
+	for(const auto& triangle : triangles)
+	{
+		for(auto v : triangle)
+		{
+			if(remap[v] == none)
+				remap[v] = next++;
+		}
+	}
+
+	for(auto& index : remap)
+	{
+		if(index == none)
+			index = next++;
+	}
+
+	return remap;
+}
+
+namespace
+{
+
+template <class Attribute>
+void remap_attribute(std::optional<std::vector<Attribute>>& attribute,
+					 const std::vector<unsigned int>& remap)
+{
+	if(attribute)
+		remap_vertices(attribute->data(), remap);
+}
+
+} // namespace
+
+std::vector<unsigned int> optimize_triangles(Triangle_list& triangles, size_t nb_vertices)
+{
+	// Ordre des triangles
+	{
+		auto order = vertex_cache_order(triangles, nb_vertices);
+
+		Triangle_list ordered_triangles(triangles.size());
+
+		for(size_t i = 0; i < order.size(); ++i)
+			ordered_triangles[i] = triangles[order[i]];
+
+		triangles.swap(ordered_triangles);
+	}
+
+	// Ordre des sommets
+	auto remap = vertex_fetch_remap(triangles, nb_vertices);
+
+	for(auto& triangle : triangles)
+	{
+		for(auto& v : triangle)
+			v = remap[v];
+	}
+
+	return remap;
+}
+
+std::pair<double, double> optimize_mesh_data(Mesh_data& mesh_data)
+{
+	if(!mesh_data.positions || !mesh_data.triangulated_faces)
+		return {0.0, 0.0};
+
+	auto& faces		   = *mesh_data.triangulated_faces;
+	size_t nb_vertices = mesh_data.positions->size();
+
+	double acmr_before = average_cache_miss_ratio(faces, nb_vertices);
+
+	auto remap = optimize_triangles(faces, nb_vertices);
+
+	remap_attribute(mesh_data.positions, remap);
+	remap_attribute(mesh_data.normals, remap);
+	remap_attribute(mesh_data.colors, remap);
+	remap_attribute(mesh_data.texcoords, remap);
+
+	return {acmr_before, average_cache_miss_ratio(faces, nb_vertices)};
+}
@@ -0,0 +1,58 @@
+#ifndef MESH_OPTIMIZATION_HPP
+#define MESH_OPTIMIZATION_HPP
+
+// PROJECT
+
+#include "data.hpp"
+
+// STD
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Optimisation de l'ordre des index pour l'affichage : les triangles sont réordonnés pour le cache
+// des sommets transformés du GPU (algorithme de Forsyth, "Linear-Speed Vertex Cache
+// Optimisation"), puis les sommets sont renumérotés dans l'ordre de leur première utilisation
+// pour que leur lecture soit séquentielle.
+//
+// L'efficacité du cache est mesurée par l'ACMR (average cache miss ratio) : nombre moyen de
+// sommets transformés par triangle, entre 0.5 (optimal sur un maillage régulier) et 3.
+
+using Triangle_list = std::vector<Mesh_data::vec_3u>;
+
+// ACMR d'une liste de triangles avec un cache FIFO de 'cache_size' sommets
+double average_cache_miss_ratio(const Triangle_list& triangles, size_t nb_vertices,
+								size_t cache_size = 32);
+
+// Ordre des triangles qui minimise les défauts d'un cache LRU de 'cache_size' sommets :
+// order[i] est l'index du triangle à placer en i-ème position.
+std::vector<unsigned int> vertex_cache_order(const Triangle_list& triangles, size_t nb_vertices,
+											 size_t cache_size = 32);
+
+// Nouvelle numérotation des sommets dans l'ordre de leur première utilisation par 'triangles' :
+// remap[v] est le nouvel index du sommet v (les sommets inutilisés sont placés à la fin).
+std::vector<unsigned int> vertex_fetch_remap(const Triangle_list& triangles, size_t nb_vertices);
+
+// Réordonne 'triangles' (vertex_cache_order) et renumérote leurs sommets (vertex_fetch_remap).
+// Renvoie la renumérotation à appliquer aux attributs des sommets (cf. remap_vertices).
+std::vector<unsigned int> optimize_triangles(Triangle_list& triangles, size_t nb_vertices);
+
+// Déplace la valeur du sommet v de 'values' (remap.size() éléments) en remap[v]
+template <class T>
+void remap_vertices(T* values, const std::vector<unsigned int>& remap)
+{
+	std::vector<T> remapped(remap.size());
+
+	for(size_t v = 0; v < remap.size(); ++v)
+		remapped[remap[v]] = values[v];
+
+	std::copy(remapped.begin(), remapped.end(), values);
+}
+
+// Applique optimize_triangles aux faces et aux attributs de 'mesh_data' et renvoie l'ACMR avant
+// et après l'optimisation.
+std::pair<double, double> optimize_mesh_data(Mesh_data& mesh_data);
+
+#endif // MESH_OPTIMIZATION_HPP
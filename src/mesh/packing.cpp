@@ -0,0 +1,201 @@
+#include "packing.hpp"
+
+// PROJECT
+
+#include "parallel.hpp"
+
+// STD
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+// Valeur normalisée ([-1, 1] ou [0, 1]) convertie en entier dans [min, max]
+long quantize(float value, float min, float max)
+{
+	return std::lround(std::clamp(value * max, min, max));
+}
+
+} // namespace
+
+std::uint32_t pack_normal_2_10_10_10(const Mesh_data::vec_3f& normal)
+{
+	std::uint32_t packed = 0;
+
+	// x, y, z sur 10 bits signés (le mot de 2 bits w reste à 0)
+	for(size_t c = 0; c < 3; ++c)
+	{
+		auto value = static_cast<std::uint32_t>(quantize(normal[c], -511.0f, 511.0f));
+		packed |= (value & 0x3FFu) << (10 * c);
+	}
+
+	return packed;
+}
+
+std::uint32_t pack_normal_bytes(const Mesh_data::vec_3f& normal)
+{
+	std::uint32_t packed = 0;
+
+	for(size_t c = 0; c < 3; ++c)
+	{
+		auto value = static_cast<std::uint32_t>(quantize(normal[c], -127.0f, 127.0f));
+		packed |= (value & 0xFFu) << (8 * c);
+	}
+
+	return packed;
+}
+
+std::uint32_t pack_color_bytes(const Mesh_data::vec_4f& color)
+{
+	std::uint32_t packed = 0;
+
+	for(size_t c = 0; c < 4; ++c)
+	{
+		auto value = static_cast<std::uint32_t>(quantize(color[c], 0.0f, 255.0f));
+		packed |= value << (8 * c);
+	}
+
+	return packed;
+}
+
+std::uint16_t to_half_float(float value)
+{
+	std::uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	std::uint32_t sign	   = (bits >> 16) & 0x8000u;
+	std::uint32_t exponent = (bits >> 23) & 0xFFu;
+	std::uint32_t mantissa = bits & 0x7FFFFFu;
+
+	// Infini et NaN
+	if(exponent == 0xFF)
+		return static_cast<std::uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+	int half_exponent = static_cast<int>(exponent) - 127 + 15;
+
+	if(half_exponent >= 0x1F)
+		return static_cast<std::uint16_t>(sign | 0x7C00u);
+
+	// Dénormalisés (ou zéro) : le bit implicite est ajouté à la mantisse décalée
+	if(half_exponent <= 0)
+	{
+		if(half_exponent < -10)
+			return static_cast<std::uint16_t>(sign);
+
+		mantissa |= 0x800000u;
+
+		std::uint32_t shift		= static_cast<std::uint32_t>(14 - half_exponent);
+		std::uint32_t half		= mantissa >> shift;
+		std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+		std::uint32_t halfway	= 1u << (shift - 1);
+
+		if(remainder > halfway || (remainder == halfway && (half & 1u)))
+			++half;
+
+		return static_cast<std::uint16_t>(sign | half);
+	}
+
+	std::uint32_t half = sign | (static_cast<std::uint32_t>(half_exponent) << 10) | (mantissa >> 13);
+	std::uint32_t remainder = mantissa & 0x1FFFu;
+
+	// Arrondi au pair le plus proche, la retenue peut passer dans l'exposant
+	if(remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+		++half;
+
+	return static_cast<std::uint16_t>(half);
+}
+
+Packed_layout packed_layout(const Mesh_data& mesh_data, bool packed_normals)
+{
+	Packed_layout layout;
+
+	if(!mesh_data.positions)
+		return layout;
+
+	auto append = [&layout](int& offset, size_t size) {
+		offset = static_cast<int>(layout.stride);
+		layout.stride += size;
+	};
+
+	append(layout.position, 3 * sizeof(float));
+
+	if(mesh_data.normals)
+	{
+		append(layout.normal, sizeof(std::uint32_t));
+		layout.normal_format = packed_normals ? Packed_layout::Normal_format::Int_2_10_10_10
+											  : Packed_layout::Normal_format::Byte_4;
+	}
+
+	if(mesh_data.colors)
+		append(layout.color, sizeof(std::uint32_t));
+
+	if(mesh_data.texcoords)
+	{
+		append(layout.texcoord, 2 * sizeof(std::uint16_t));
+
+		// Les coordonnées normalisées sur 16 bits sont plus précises que des demi-flottants
+		// (2^-16 contre 2^-11 près de 1) mais ne peuvent pas représenter une texture répétée
+		bool in_unit_square =
+			std::all_of(mesh_data.texcoords->begin(), mesh_data.texcoords->end(),
+						[](const Mesh_data::vec_2f& texcoord) {
+							return texcoord[0] >= 0.0f && texcoord[0] <= 1.0f &&
+								   texcoord[1] >= 0.0f && texcoord[1] <= 1.0f;
+						});
+
+		layout.texcoord_format = in_unit_square ? Packed_layout::Texcoord_format::Unorm_16
+												: Packed_layout::Texcoord_format::Half_float;
+	}
+
+	return layout;
+}
+
+void pack_vertices(const Mesh_data& mesh_data, const Packed_layout& layout, char* destination)
+{
+	if(!mesh_data.positions)
+		return;
+
+	bool int_2_10_10_10 = layout.normal_format == Packed_layout::Normal_format::Int_2_10_10_10;
+	bool half_float		= layout.texcoord_format == Packed_layout::Texcoord_format::Half_float;
+
+	parallel_for_chunks(mesh_data.positions->size(), [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end; ++i)
+		{
+			char* vertex = destination + i * layout.stride;
+
+			std::memcpy(vertex + layout.position, (*mesh_data.positions)[i].data(),
+						3 * sizeof(float));
+
+			if(layout.normal >= 0)
+			{
+				const auto& normal = (*mesh_data.normals)[i];
+				std::uint32_t packed =
+					int_2_10_10_10 ? pack_normal_2_10_10_10(normal) : pack_normal_bytes(normal);
+				std::memcpy(vertex + layout.normal, &packed, sizeof(packed));
+			}
+
+			if(layout.color >= 0)
+			{
+				std::uint32_t packed = pack_color_bytes((*mesh_data.colors)[i]);
+				std::memcpy(vertex + layout.color, &packed, sizeof(packed));
+			}
+
+			if(layout.texcoord >= 0)
+			{
+				const auto& texcoord = (*mesh_data.texcoords)[i];
+				std::uint16_t packed[2];
+
+				for(size_t c = 0; c < 2; ++c)
+				{
+					packed[c] = half_float ? to_half_float(texcoord[c])
+										   : static_cast<std::uint16_t>(
+												 quantize(texcoord[c], 0.0f, 65535.0f));
+				}
+
+				std::memcpy(vertex + layout.texcoord, packed, sizeof(packed));
+			}
+		}
+	});
+}
@@ -0,0 +1,55 @@
+#ifndef MESH_PACKING_HPP
+#define MESH_PACKING_HPP
+
+// PROJECT
+
+#include "data.hpp"
+
+// STD
+
+#include <cstddef>
+#include <cstdint>
+
+// Disposition compacte d'un sommet dans un tampon entrelacé pour l'affichage : les positions
+// restent en float (précision des scans) mais les normales, couleurs et coordonnées de texture
+// tiennent chacune sur 4 octets, soit 24 octets par sommet au lieu de 48 en float.
+// Les décalages sont en octets dans le sommet, -1 si l'attribut est absent.
+struct Packed_layout
+{
+	enum class Normal_format
+	{
+		Int_2_10_10_10, // GL_INT_2_10_10_10_REV (OpenGL 3.3)
+		Byte_4			// GL_BYTE x 4, même taille pour les contextes plus anciens
+	};
+
+	enum class Texcoord_format
+	{
+		Unorm_16,  // GL_UNSIGNED_SHORT x 2 normalisés, si toutes les coordonnées sont dans [0, 1]
+		Half_float // GL_HALF_FLOAT x 2 sinon (textures répétées)
+	};
+
+	size_t stride = 0;
+	int position  = -1;
+	int normal	  = -1;
+	int color	  = -1;
+	int texcoord  = -1;
+
+	Normal_format normal_format		= Normal_format::Int_2_10_10_10;
+	Texcoord_format texcoord_format = Texcoord_format::Unorm_16;
+};
+
+// Disposition des attributs présents dans 'mesh_data'. 'packed_normals' indique si le format
+// GL_INT_2_10_10_10_REV est utilisable comme attribut de sommet.
+Packed_layout packed_layout(const Mesh_data& mesh_data, bool packed_normals = true);
+
+// Écrit les sommets de 'mesh_data' dans 'destination' (positions->size() * layout.stride
+// octets), en parallèle. 'destination' peut être la mémoire d'un buffer OpenGL projeté.
+void pack_vertices(const Mesh_data& mesh_data, const Packed_layout& layout, char* destination);
+
+// Conversions élémentaires (les valeurs sont arrondies au plus proche)
+std::uint32_t pack_normal_2_10_10_10(const Mesh_data::vec_3f& normal);
+std::uint32_t pack_normal_bytes(const Mesh_data::vec_3f& normal);
+std::uint32_t pack_color_bytes(const Mesh_data::vec_4f& color);
+std::uint16_t to_half_float(float value);
+
+#endif // MESH_PACKING_HPP
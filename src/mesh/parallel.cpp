@@ -0,0 +1,26 @@
+#include "parallel.hpp"
+
+// STD
+
+#include <atomic>
+#include <thread>
+
+namespace
+{
+std::atomic<unsigned int> g_number_of_threads{0};
+}
+
+void set_number_of_threads(unsigned int nb_threads)
+{
+	g_number_of_threads = nb_threads;
+}
+
+unsigned int number_of_threads()
+{
+	unsigned int nb_threads = g_number_of_threads;
+
+	if(nb_threads == 0)
+		nb_threads = std::thread::hardware_concurrency();
+
+	return nb_threads == 0 ? 1 : nb_threads;
+}
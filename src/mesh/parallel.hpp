@@ -0,0 +1,32 @@
+#ifndef MESH_PARALLEL_HPP
+#define MESH_PARALLEL_HPP
+
+// STD
+
+#include <cstddef>
+
+// Nombre de threads utilisés par les traitements parallèles (0 = nombre de coeurs de la machine).
+void set_number_of_threads(unsigned int nb_threads);
+unsigned int number_of_threads();
+
+// Découpe l'intervalle [0, size) en blocs contigus et appelle 'function(begin, end)' sur chaque
+// bloc depuis un thread différent. Les blocs ne se chevauchent pas : chaque index est traité une
+// seule fois, il est donc possible d'écrire dans un tableau pré-alloué sans synchronisation.
+template <class Function>
+void parallel_for_chunks(std::size_t size, Function&& function, std::size_t min_chunk_size = 1024);
+
+// Appelle 'function(i)' pour chaque index i de [0, size) en parallèle.
+template <class Function>
+void parallel_for(std::size_t size, Function&& function, std::size_t min_chunk_size = 1024);
+
+// Renvoie les valeurs 'value(i)' des index i de [0, size) pour lesquels 'predicate(i)' est vrai,
+// dans l'ordre croissant des index. Le prédicat est évalué une seule fois par index : chaque bloc
+// compte ses éléments retenus, les comptes sont cumulés puis chaque bloc recopie ses valeurs à sa
+// place. Le résultat ne dépend donc pas du nombre de threads.
+template <class Predicate, class Value>
+auto parallel_select(std::size_t size, Predicate&& predicate, Value&& value,
+					 std::size_t min_chunk_size = 1024);
+
+#include "parallel.inl"
+
+#endif // MESH_PARALLEL_HPP
@@ -0,0 +1,140 @@
+#ifndef MESH_PARALLEL_INL
+#define MESH_PARALLEL_INL
+
+#include "parallel.hpp"
+
+// STD
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+template <class Function>
+void parallel_for_chunks(std::size_t size, Function&& function, std::size_t min_chunk_size)
+{
+	if(size == 0)
+		return;
+
+	min_chunk_size = std::max<std::size_t>(min_chunk_size, 1);
+
+	std::size_t nb_chunks = std::min<std::size_t>(
+		number_of_threads(), (size + min_chunk_size - 1) / min_chunk_size);
+
+	if(nb_chunks <= 1)
+	{
+		function(std::size_t(0), size);
+		return;
+	}
+
+	// Découpage statique : les premiers blocs récupèrent le reste de la division
+	std::size_t chunk_size = size / nb_chunks;
+	std::size_t remainder  = size % nb_chunks;
+
+	std::vector<std::thread> workers;
+	std::vector<std::exception_ptr> errors(nb_chunks);
+
+	workers.reserve(nb_chunks - 1);
+
+	std::size_t begin = 0;
+
+	for(std::size_t c = 0; c < nb_chunks; ++c)
+	{
+		std::size_t end = begin + chunk_size + (c < remainder ? 1 : 0);
+
+		auto task = [&function, &errors, c, begin, end]() {
+			try
+			{
+				function(begin, end);
+			}
+			catch(...)
+			{
+				errors[c] = std::current_exception();
+			}
+		};
+
+		// Le dernier bloc est traité par le thread appelant
+		if(c + 1 == nb_chunks)
+			task();
+		else
+			workers.emplace_back(task);
+
+		begin = end;
+	}
+
+	for(auto& worker : workers)
+		worker.join();
+
+	for(auto& error : errors)
+	{
+		if(error)
+			std::rethrow_exception(error);
+	}
+}
+
+template <class Function>
+void parallel_for(std::size_t size, Function&& function, std::size_t min_chunk_size)
+{
+	parallel_for_chunks(
+		size,
+		[&function](std::size_t begin, std::size_t end) {
+			for(std::size_t i = begin; i < end; ++i)
+				function(i);
+		},
+		min_chunk_size);
+}
+
+template <class Predicate, class Value>
+auto parallel_select(std::size_t size, Predicate&& predicate, Value&& value,
+					 std::size_t min_chunk_size)
+{
+	using Result = std::decay_t<decltype(value(std::size_t(0)))>;
+
+	// Les blocs sont fixes (et non ceux de parallel_for_chunks) pour que la position de chaque
+	// valeur ne dépende que des blocs qui la précèdent
+	std::size_t block_size = std::max<std::size_t>(min_chunk_size, 1);
+	std::size_t nb_blocks  = (size + block_size - 1) / block_size;
+
+	std::vector<unsigned char> selected(size);
+	std::vector<std::size_t> offsets(nb_blocks + 1, 0);
+
+	parallel_for(
+		nb_blocks,
+		[&](std::size_t b) {
+			std::size_t end	  = std::min(size, (b + 1) * block_size);
+			std::size_t count = 0;
+
+			for(std::size_t i = b * block_size; i < end; ++i)
+			{
+				selected[i] = predicate(i) ? 1 : 0;
+				count += selected[i];
+			}
+
+			offsets[b + 1] = count;
+		},
+		1);
+
+	for(std::size_t b = 0; b < nb_blocks; ++b)
+		offsets[b + 1] += offsets[b];
+
+	std::vector<Result> result(offsets.back());
+
+	parallel_for(
+		nb_blocks,
+		[&](std::size_t b) {
+			std::size_t end = std::min(size, (b + 1) * block_size);
+			std::size_t n	= offsets[b];
+
+			for(std::size_t i = b * block_size; i < end; ++i)
+			{
+				if(selected[i])
+					result[n++] = value(i);
+			}
+		},
+		1);
+
+	return result;
+}
+
+#endif // MESH_PARALLEL_INL
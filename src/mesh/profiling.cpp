@@ -0,0 +1,87 @@
+#include "profiling.hpp"
+
+// STD
+
+#include <fstream>
+#include <string>
+
+#if defined(_WIN32)
+// clang-format off
+#include <windows.h>
+#include <psapi.h>
+// clang-format on
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+#if defined(__linux__)
+// Lit un champ en kB de /proc/self/status (VmRSS, VmHWM, ...)
+size_t read_proc_status(const std::string& field)
+{
+	std::ifstream status("/proc/self/status");
+	std::string line;
+
+	while(std::getline(status, line))
+	{
+		if(line.compare(0, field.size(), field) == 0 && line[field.size()] == ':')
+			return std::stoul(line.substr(field.size() + 1)) * 1024;
+	}
+
+	return 0;
+}
+#endif
+} // namespace
+
+size_t current_memory_usage()
+{
+#if defined(__linux__)
+	return read_proc_status("VmRSS");
+#elif defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+
+	return 0;
+#else
+	return 0;
+#endif
+}
+
+size_t peak_memory_usage()
+{
+#if defined(__linux__)
+	return read_proc_status("VmHWM");
+#elif defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+
+	return 0;
+#elif defined(__APPLE__)
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return static_cast<size_t>(usage.ru_maxrss); // en octets sous macOS
+#elif defined(__unix__)
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#else
+	return 0;
+#endif
+}
+
+bool reset_peak_memory_usage()
+{
+#if defined(__linux__)
+	std::ofstream clear_refs("/proc/self/clear_refs");
+	clear_refs << "5";
+	clear_refs.close();
+	return static_cast<bool>(clear_refs);
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,19 @@
+#ifndef MESH_PROFILING_HPP
+#define MESH_PROFILING_HPP
+
+// STD
+
+#include <cstddef>
+
+// Mémoire résidente (RSS) du processus en octets, 0 si elle n'est pas disponible sur le système
+size_t current_memory_usage();
+
+// Pic de mémoire résidente du processus en octets depuis son lancement (ou depuis le dernier appel
+// réussi à reset_peak_memory_usage)
+size_t peak_memory_usage();
+
+// Remet le pic de mémoire résidente à la mémoire courante. Renvoie faux si le système ne le permet
+// pas (seul linux le permet, via /proc/self/clear_refs).
+bool reset_peak_memory_usage();
+
+#endif // MESH_PROFILING_HPP
@@ -2,53 +2,135 @@
 #define MESH_PROJECTION_HPP
 
 #include "../instance/Surface_mesh_kd_tree.hpp"
+#include "flat.hpp"
+#include "kernel.hpp"
+#include "result.hpp"
+#include "search.hpp"
 
-// Noyau utilisé pour changer les paramètre de la projection d'un maillage sur un autre.
-struct Weight_kernel
-{
-	enum class Type
-	{
-		Gaussian,
-		Wendland,
-		Singular,
-		Uniform
-	};
-
-	enum Mode
-	{
-		Constant,
-		Max,
-		Adaptive
-	};
-
-	Type type		 = Type::Gaussian;
-	Mode radius_mode = Mode::Adaptive;
-
-	double radius	  = 0;
-	double s_exponent = 0;
-
-	// Constant : r = radius
-	// Max      : r = max(radius , max(r[i] , i \in neighbors))
-	// Adaptive : r = max(r[i] , i \in neighbors)
-
-	double weight(double d, double neihboringSphereRadius) const;
-};
+// STD
+
+#include <ostream>
+#include <vector>
 
 // Normalize un vecteur pour que sa taille soit unitaire
 Kernel::Vector_3 normalized(const Kernel::Vector_3& v);
 
-// Projection APSS d'un point sur un ensemble de points avec des normales
+// Critères d'arrêt anticipé de APSS, relatifs au rayon du voisinage courant (maxDist)
+// - tolerance   : la projection s'arrête dès que le point se déplace de moins de tolerance * maxDist
+// - reuse_ratio : le voisinage précédent est réutilisé (sans requête kd-tree) tant que le point s'est
+//                 déplacé de moins de reuse_ratio * maxDist depuis la dernière requête
+// Des valeurs nulles redonnent le comportement historique (nb_iterations requêtes par point).
+struct APSS_convergence
+{
+	double tolerance   = 1e-6;
+	double reuse_ratio = 0.05;
+};
+
+// Compteurs permettant de mesurer le coût réel des projections APSS
+struct APSS_statistics
+{
+	size_t nb_projections = 0; // points projetés
+	size_t nb_iterations  = 0; // itérations effectuées
+	size_t nb_queries	  = 0; // requêtes de K plus proches voisins effectuées
+	size_t nb_converged	  = 0; // projections arrêtées avant nb_iterations
+
+	APSS_statistics& operator+=(const APSS_statistics& other);
+
+	double average_iterations() const;
+	double average_queries() const;
+};
+
+std::ostream& operator<<(std::ostream& os, const APSS_statistics& statistics);
+
+// Projection APSS d'un point sur un ensemble de points avec des normales. Le noyau décrit à
+// l'exécution est converti une fois en noyau compilé (cf. dispatch_weight_kernel). Cette version
+// alloue son propre voisinage : les projections en série utilisent APSS_with_neighbors.
 std::pair<Kernel::Point_3, Kernel::Vector_3>
 	APSS(const Kernel::Point_3& input_point, const SM_kd_tree& kd_tree,
 		 const Surface_mesh_normal_map& normals, const size_t nb_iterations = 20,
 		 const unsigned int K				= 20,
 		 const Weight_kernel& weight_kernel = {Weight_kernel::Type::Gaussian,
-											   Weight_kernel::Mode::Adaptive, 0, 0});
+											   Weight_kernel::Mode::Adaptive, 0, 0},
+		 const APSS_convergence& convergence = {}, APSS_statistics* statistics = nullptr);
+
+// Positions et normales des voisins renvoyés par le kd-tree, lues dans le Surface_mesh indexé
+struct Surface_mesh_neighbors
+{
+	Surface_mesh::Property_map<Surface_mesh::Vertex_index, Surface_mesh::Point> positions;
+	Surface_mesh_normal_map normals;
+
+	void fetch(Surface_mesh::Vertex_index v, APSS_neighborhood& neighborhood, size_t j) const;
+};
+
+// Positions et normales des voisins lues dans les tableaux de la vue compacte du maillage indexé
+// Precondition : 'mesh' doit avoir des normales et le kd-tree indexer les sommets du maillage
+// à partir duquel 'mesh' a été construit
+struct Flat_mesh_neighbors
+{
+	const Flat_mesh& mesh;
+
+	void fetch(Surface_mesh::Vertex_index v, APSS_neighborhood& neighborhood, size_t j) const;
+};
+
+// Projection APSS avec un noyau compilé (Gaussian_kernel, Wendland_kernel, ...). Les voisins
+// trouvés dans 'kd_tree' sont lus par 'neighbors' (Surface_mesh_neighbors, Flat_mesh_neighbors)
+// et rangés dans 'neighborhood', mémoire de travail à réutiliser d'un point à l'autre (un
+// voisinage par thread) pour ne pas allouer à chaque projection.
+template <class Neighbors, class WeightKernel>
+std::pair<Kernel::Point_3, Kernel::Vector_3>
+	APSS_with_neighbors(const Kernel::Point_3& input_point, const SM_kd_tree& kd_tree,
+						const Neighbors& neighbors, const size_t nb_iterations,
+						const unsigned int K, const WeightKernel& weight_kernel,
+						const APSS_convergence& convergence, APSS_statistics* statistics,
+						APSS_neighborhood& neighborhood);
+
+template <class WeightKernel>
+std::pair<Kernel::Point_3, Kernel::Vector_3>
+	APSS(const Kernel::Point_3& input_point, const SM_kd_tree& kd_tree,
+		 const Surface_mesh_normal_map& normals, const size_t nb_iterations, const unsigned int K,
+		 const WeightKernel& weight_kernel, const APSS_convergence& convergence,
+		 APSS_statistics* statistics, APSS_neighborhood& neighborhood);
+
+// Projette les sommets 'vertices' de 'mesh' et écrit les positions obtenues dans
+// 'projected_points' (préalloué, un point par sommet dans l'ordre de 'vertices') sans modifier
+// le maillage.
+template <class VertexRange, class WeightKernel = Gaussian_kernel<>>
+void project_points(const Surface_mesh& mesh, const VertexRange& vertices,
+					const SM_kd_tree& points, const Surface_mesh_normal_map& normals,
+					Kernel::Point_3* projected_points, APSS_statistics* statistics = nullptr,
+					const WeightKernel& weight_kernel = {});
+
+// Projection en place des sommets 'vertices' de 'mesh' (aucune copie du maillage)
+// Les statistiques APSS de la projection sont affichées et cumulées dans 'statistics' si fourni.
+template <class VertexRange, class WeightKernel = Gaussian_kernel<>>
+void project(Surface_mesh& mesh, const VertexRange& vertices, const SM_kd_tree& points,
+			 const Surface_mesh_normal_map& normals, APSS_statistics* statistics = nullptr,
+			 const WeightKernel& weight_kernel = {});
+
+// Comme ci-dessus avec un noyau choisi à l'exécution, converti une fois pour tous les points
+template <class VertexRange>
+void project(Surface_mesh& mesh, const VertexRange& vertices, const SM_kd_tree& points,
+			 const Surface_mesh_normal_map& normals, APSS_statistics* statistics,
+			 const Weight_kernel& weight_kernel);
 
 // Projection d'un maillage sur un autre (M1 est projeté sur M2)
+// La version qui prend une référence constante projette une copie du maillage, celle qui prend
+// une rvalue projette le maillage reçu et le renvoie sans le copier.
+template <class VertexRange, class WeightKernel = Gaussian_kernel<>>
+Surface_mesh projection(const Surface_mesh& mesh, const VertexRange& vertices,
+						const SM_kd_tree& points, const Surface_mesh_normal_map& normals,
+						APSS_statistics* statistics = nullptr, const WeightKernel& weight_kernel = {});
+
+template <class VertexRange, class WeightKernel = Gaussian_kernel<>>
+Surface_mesh projection(Surface_mesh&& mesh, const VertexRange& vertices,
+						const SM_kd_tree& points, const Surface_mesh_normal_map& normals,
+						APSS_statistics* statistics = nullptr, const WeightKernel& weight_kernel = {});
+
+// Comme ci-dessus avec un noyau choisi à l'exécution, converti une fois pour tous les points
 template <class VertexRange>
 Surface_mesh projection(const Surface_mesh& mesh, const VertexRange& vertices,
-						const SM_kd_tree& points, const Surface_mesh_normal_map& normals);
+						const SM_kd_tree& points, const Surface_mesh_normal_map& normals,
+						APSS_statistics* statistics, const Weight_kernel& weight_kernel);
 
 template <class VertexRange1, class VertexRange2>
 Surface_mesh projection(const Surface_mesh& M1, const VertexRange1& M1_vertices,
@@ -56,6 +138,48 @@ Surface_mesh projection(const Surface_mesh& M1, const VertexRange1& M1_vertices,
 
 Surface_mesh projection(const Surface_mesh& M1, const Surface_mesh& M2);
 
+// Projection en place des positions de la vue compacte d'un maillage (cf. flat.hpp) sur la vue
+// compacte 'M2' : positions et normales des voisins sont lues dans les tableaux de M2.
+// Precondition : 'M2_tree' indexe les sommets du maillage à partir duquel M2 a été construit et
+// M2 a des normales
+template <class WeightKernel = Gaussian_kernel<>>
+void projection(Flat_mesh& mesh, const Flat_mesh& M2, const SM_kd_tree& M2_tree,
+				APSS_statistics* statistics = nullptr, const WeightKernel& weight_kernel = {});
+
+void projection(Flat_mesh& mesh, const Flat_mesh& M2, const SM_kd_tree& M2_tree,
+				APSS_statistics* statistics, const Weight_kernel& weight_kernel);
+
+// Comme projection(M1, M2) mais en réutilisant l'arbre de M2 conservé dans 'kd_trees'
+Surface_mesh projection(const Surface_mesh& M1, const Surface_mesh& M2,
+						SM_kd_tree_cache& kd_trees, const Weight_kernel& weight_kernel = {});
+
+Surface_mesh projection(Surface_mesh&& M1, const Surface_mesh& M2, SM_kd_tree_cache& kd_trees,
+						const Weight_kernel& weight_kernel = {});
+
+// Projection en place de M1 sur M2 ; l'arbre de M1 éventuellement présent dans 'kd_trees' est
+// invalidé
+void project(Surface_mesh& M1, const Surface_mesh& M2, SM_kd_tree_cache& kd_trees,
+			 const Weight_kernel& weight_kernel = {});
+
+// Les projections sur un maillage M2 quittent le programme si M2 n'a pas de normales ('v:normal'),
+// les variantes try_* renvoient l'erreur à la place (M1 n'est alors pas modifié). Elles renvoient
+// aussi une erreur si M2 est vide, avant de construire son arbre.
+Result<Surface_mesh_normal_map> try_get_normal_map(const Surface_mesh& mesh);
+
+Status try_project(Surface_mesh& M1, const Surface_mesh& M2, SM_kd_tree_cache& kd_trees,
+				   const Weight_kernel& weight_kernel = {});
+
+Result<Surface_mesh> try_projection(const Surface_mesh& M1, const Surface_mesh& M2,
+									SM_kd_tree_cache& kd_trees,
+									const Weight_kernel& weight_kernel = {});
+
+// Comme try_project mais les positions projetées des sommets de M1 sont écrites dans
+// 'projected_points' (redimensionné, un point par sommet dans l'ordre de M1.vertices()) : M1 n'est
+// ni modifié ni copié, sa projection partage sa connectivité.
+Status try_project_points(const Surface_mesh& M1, const Surface_mesh& M2,
+						  SM_kd_tree_cache& kd_trees, std::vector<Kernel::Point_3>& projected_points,
+						  const Weight_kernel& weight_kernel = {});
+
 #include "projection.inl"
 
 #endif // MESH_PROJECTION_HPP
\ No newline at end of file
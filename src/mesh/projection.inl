@@ -3,76 +3,158 @@
 
 #include "projection.hpp"
 
+#include "parallel.hpp"
+
 #include <cmath>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
 
-double Weight_kernel::weight(double d, double neihboringSphereRadius) const
+Kernel::Vector_3 normalized(const Kernel::Vector_3& v)
 {
-	double r = radius_mode == Mode::Constant
-				   ? radius
-				   : radius_mode == Mode::Max ? std::max<double>(radius, neihboringSphereRadius)
-											  : neihboringSphereRadius;
-	if(type == Type::Gaussian)
-		return std::exp(-d * d / (r * r));
-	else if(type == Type::Wendland)
-		return std::pow(1 - d / r, 4) * (1 + 4 * d / r);
-	else if(type == Type::Singular)
-		return std::pow(r / d, s_exponent);
-	else
-		return 1.0;
+	return v / std::sqrt(v.squared_length());
 }
 
-Kernel::Vector_3 normalized(const Kernel::Vector_3& v)
+APSS_statistics& APSS_statistics::operator+=(const APSS_statistics& other)
 {
-	return v / std::sqrt(v.squared_length());
+	nb_projections += other.nb_projections;
+	nb_iterations += other.nb_iterations;
+	nb_queries += other.nb_queries;
+	nb_converged += other.nb_converged;
+	return *this;
 }
 
-std::pair<Kernel::Point_3, Kernel::Vector_3> APSS(const Kernel::Point_3& input_point,
-												  const SM_kd_tree& kd_tree,
-												  const Surface_mesh_normal_map& normals,
-												  const size_t nb_iterations, const unsigned int K,
-												  const Weight_kernel& weight_kernel)
+double APSS_statistics::average_iterations() const
+{
+	return nb_projections == 0 ? 0 : static_cast<double>(nb_iterations) / nb_projections;
+}
+
+double APSS_statistics::average_queries() const
+{
+	return nb_projections == 0 ? 0 : static_cast<double>(nb_queries) / nb_projections;
+}
+
+std::ostream& operator<<(std::ostream& os, const APSS_statistics& statistics)
+{
+	return os << statistics.nb_projections << " projection(s), " << statistics.nb_converged
+			  << " converged early, " << statistics.average_iterations()
+			  << " iteration(s) and " << statistics.average_queries()
+			  << " kd-tree querie(s) per point on average";
+}
+
+void Surface_mesh_neighbors::fetch(Surface_mesh::Vertex_index v, APSS_neighborhood& neighborhood,
+								   size_t j) const
+{
+	const auto& position = positions[v];
+	const auto& normal	 = normals[v];
+
+	neighborhood.px[j] = position[0];
+	neighborhood.py[j] = position[1];
+	neighborhood.pz[j] = position[2];
+	neighborhood.nx[j] = normal[0];
+	neighborhood.ny[j] = normal[1];
+	neighborhood.nz[j] = normal[2];
+}
+
+void Flat_mesh_neighbors::fetch(Surface_mesh::Vertex_index v, APSS_neighborhood& neighborhood,
+								size_t j) const
+{
+	size_t i = mesh.dense_index[v];
+
+	neighborhood.px[j] = mesh.x[i];
+	neighborhood.py[j] = mesh.y[i];
+	neighborhood.pz[j] = mesh.z[i];
+	neighborhood.nx[j] = mesh.nx[i];
+	neighborhood.ny[j] = mesh.ny[i];
+	neighborhood.nz[j] = mesh.nz[i];
+}
+
+template <class Neighbors, class WeightKernel>
+std::pair<Kernel::Point_3, Kernel::Vector_3>
+	APSS_with_neighbors(const Kernel::Point_3& input_point, const SM_kd_tree& kd_tree,
+						const Neighbors& neighbors, const size_t nb_iterations,
+						const unsigned int K, const WeightKernel& weight_kernel,
+						const APSS_convergence& convergence, APSS_statistics* statistics,
+						APSS_neighborhood& neighborhood)
 {
 	// Initisalisation
 	Kernel::Vector_3 output_normal;
 	Kernel::Vector_3 output_point_v(input_point[0], input_point[1], input_point[2]);
 
-	auto positions = kd_tree.traits().point_property_map();
+	// Voisinage de la dernière requête (la mémoire du point précédent est réutilisée)
+	neighborhood.resize(0);
 
-	for(size_t i = 0; i < nb_iterations; i++)
+	Kernel::Vector_3 query_point_v = output_point_v;
+	double maxDist				   = 0;
+
+	size_t i = 0;
+
+	for(; i < nb_iterations; i++)
 	{
-		// Find K nearest neighbors
 		Kernel::Point_3 output_point_p(output_point_v[0], output_point_v[1], output_point_v[2]);
 
-		SM_kd_tree_search search(kd_tree, output_point_p, K, 0, true,
-								 kd_tree.traits().point_property_map());
+		bool reuse_neighbors =
+			neighborhood.size() != 0 &&
+			(output_point_v - query_point_v).squared_length() <
+				(convergence.reuse_ratio * maxDist) * (convergence.reuse_ratio * maxDist);
 
-		double maxDist = std::sqrt((search.end() - 1)->second);
+		if(reuse_neighbors)
+		{
+			// Le point a peu bougé : on garde le même voisinage et on met seulement à jour
+			// les distances
+			double maxSqrDist = 0;
 
-		double s_wi		= 0;
-		double s_wipini = 0;
-		double s_wipipi = 0;
+			for(size_t j = 0; j < neighborhood.size(); ++j)
+			{
+				double dx = neighborhood.px[j] - output_point_v[0];
+				double dy = neighborhood.py[j] - output_point_v[1];
+				double dz = neighborhood.pz[j] - output_point_v[2];
 
-		Kernel::Vector_3 s_wipi(0, 0, 0);
-		Kernel::Vector_3 s_wini(0, 0, 0);
+				neighborhood.sqr_dist[j] = dx * dx + dy * dy + dz * dz;
+				maxSqrDist				 = std::max(maxSqrDist, neighborhood.sqr_dist[j]);
+			}
 
-		for(auto point_dist_squared : search)
+			maxDist = std::sqrt(maxSqrDist);
+		}
+		else
 		{
-			auto nni_idx	   = point_dist_squared.first;
-			double nni_sqrDist = point_dist_squared.second;
-			double wi		   = weight_kernel.weight(std::sqrt(nni_sqrDist), maxDist);
+			// Find K nearest neighbors
+			SM_kd_tree_search search(kd_tree, output_point_p, K, 0, true,
+									 kd_tree.traits().point_property_map());
 
-			Kernel::Vector_3 position(positions[nni_idx][0], positions[nni_idx][1],
-									  positions[nni_idx][2]);
-			Kernel::Vector_3 normal(normals[nni_idx]);
+			neighborhood.resize(static_cast<size_t>(search.end() - search.begin()));
 
-			s_wipini += (wi * CGAL::scalar_product(position, normal));
-			s_wipipi += (wi * CGAL::scalar_product(position, normal));
+			size_t j = 0;
 
-			s_wipi += (wi * position);
-			s_wini += (wi * normal);
-			s_wi += wi;
+			for(auto point_dist_squared : search)
+			{
+				neighbors.fetch(point_dist_squared.first, neighborhood, j);
+				neighborhood.sqr_dist[j] = point_dist_squared.second;
+				++j;
+			}
+
+			query_point_v = output_point_v;
+			maxDist		  = std::sqrt((search.end() - 1)->second);
+
+			if(statistics)
+				++statistics->nb_queries;
 		}
 
+		weight_kernel.compute_weights(neighborhood, maxDist);
+
+		APSS_moments moments = accumulate_moments(neighborhood);
+
+		double s_wi		= moments.s_wi;
+		double s_wipini = moments.s_wipini;
+		double s_wipipi = moments.s_wipipi;
+
+		Kernel::Vector_3 s_wipi(moments.s_wipi[0], moments.s_wipi[1], moments.s_wipi[2]);
+		Kernel::Vector_3 s_wini(moments.s_wini[0], moments.s_wini[1], moments.s_wini[2]);
+
+		Kernel::Vector_3 previous_point_v = output_point_v;
+
 		// algebraic sphere: u4.||X||^2 + u123.X + u0 = 0
 		// geometric sphere: ||X-C||^2 - r^2 = 0
 		// geometric plane:  (X-C).n = 0
@@ -106,6 +188,24 @@ std::pair<Kernel::Point_3, Kernel::Vector_3> APSS(const Kernel::Point_3& input_p
 			output_normal  = u123 + 2 * u4 * output_point_v;
 			output_normal  = normalized(output_normal);
 		}
+
+		// Convergence : le point ne bouge presque plus par rapport à la taille du voisinage
+		double tolerance = convergence.tolerance * maxDist;
+
+		if((output_point_v - previous_point_v).squared_length() < tolerance * tolerance)
+		{
+			++i;
+			break;
+		}
+	}
+
+	if(statistics)
+	{
+		++statistics->nb_projections;
+		statistics->nb_iterations += i;
+
+		if(i < nb_iterations)
+			++statistics->nb_converged;
 	}
 
 	Kernel::Point_3 output_point_p(output_point_v[0], output_point_v[1], output_point_v[2]);
@@ -113,28 +213,182 @@ std::pair<Kernel::Point_3, Kernel::Vector_3> APSS(const Kernel::Point_3& input_p
 	return {output_point_p, output_normal};
 }
 
-template <class VertexRange>
+template <class WeightKernel>
+std::pair<Kernel::Point_3, Kernel::Vector_3>
+	APSS(const Kernel::Point_3& input_point, const SM_kd_tree& kd_tree,
+		 const Surface_mesh_normal_map& normals, const size_t nb_iterations, const unsigned int K,
+		 const WeightKernel& weight_kernel, const APSS_convergence& convergence,
+		 APSS_statistics* statistics, APSS_neighborhood& neighborhood)
+{
+	Surface_mesh_neighbors neighbors{kd_tree.traits().point_property_map(), normals};
+
+	return APSS_with_neighbors(input_point, kd_tree, neighbors, nb_iterations, K, weight_kernel,
+							   convergence, statistics, neighborhood);
+}
+
+std::pair<Kernel::Point_3, Kernel::Vector_3> APSS(const Kernel::Point_3& input_point,
+												  const SM_kd_tree& kd_tree,
+												  const Surface_mesh_normal_map& normals,
+												  const size_t nb_iterations, const unsigned int K,
+												  const Weight_kernel& weight_kernel,
+												  const APSS_convergence& convergence,
+												  APSS_statistics* statistics)
+{
+	APSS_neighborhood neighborhood;
+
+	return dispatch_weight_kernel(weight_kernel, [&](const auto& kernel) {
+		return APSS(input_point, kd_tree, normals, nb_iterations, K, kernel, convergence,
+					statistics, neighborhood);
+	});
+}
+
+template <class VertexRange, class WeightKernel>
+void project_points(const Surface_mesh& mesh, const VertexRange& vertices,
+					const SM_kd_tree& points, const Surface_mesh_normal_map& normals,
+					Kernel::Point_3* projected_points, APSS_statistics* statistics,
+					const WeightKernel& weight_kernel)
+{
+	std::vector<Surface_mesh::Vertex_index> projected_vertices(vertices.begin(), vertices.end());
+
+	prepare_concurrent_queries(points);
+
+	APSS_statistics projection_statistics;
+	std::mutex statistics_mutex;
+
+	// Chaque sommet est projeté indépendamment des autres : le résultat est identique
+	// quel que soit le nombre de threads utilisés.
+	parallel_for_chunks(
+		projected_vertices.size(),
+		[&](std::size_t begin, std::size_t end) {
+			APSS_statistics chunk_statistics;
+			APSS_neighborhood neighborhood;
+
+			for(std::size_t i = begin; i < end; ++i)
+			{
+				projected_points[i] = APSS(mesh.point(projected_vertices[i]), points, normals, 20,
+										   20, weight_kernel, {}, &chunk_statistics, neighborhood)
+										  .first;
+			}
+
+			std::lock_guard<std::mutex> lock(statistics_mutex);
+			projection_statistics += chunk_statistics;
+		},
+		64);
+
+	std::clog << "[STATUS] APSS : " << projection_statistics << '\n';
+
+	if(statistics)
+		*statistics += projection_statistics;
+}
+
+template <class VertexRange, class WeightKernel>
+void project(Surface_mesh& mesh, const VertexRange& vertices, const SM_kd_tree& points,
+			 const Surface_mesh_normal_map& normals, APSS_statistics* statistics,
+			 const WeightKernel& weight_kernel)
+{
+	// Les positions projetées sont écrites à part : l'arbre peut contenir les sommets de 'mesh'
+	std::vector<Kernel::Point_3> projected_points(
+		static_cast<size_t>(std::distance(vertices.begin(), vertices.end())));
+
+	project_points(mesh, vertices, points, normals, projected_points.data(), statistics,
+				   weight_kernel);
+
+	size_t i = 0;
+
+	for(auto v : vertices)
+		mesh.point(v) = projected_points[i++];
+}
+
+template <class VertexRange, class WeightKernel>
 Surface_mesh projection(const Surface_mesh& mesh, const VertexRange& vertices,
-						const SM_kd_tree& points, const Surface_mesh_normal_map& normals)
+						const SM_kd_tree& points, const Surface_mesh_normal_map& normals,
+						APSS_statistics* statistics, const WeightKernel& weight_kernel)
 {
 	Surface_mesh result = mesh;
+	project(result, vertices, points, normals, statistics, weight_kernel);
 
-	// auto [result_normal, created] = result.add_property_map<Mesh::Vertex_index,
-	// Vector>("v:normal");
+	return result;
+}
 
-	// if(created)
-	// std::cerr << "result_map created\n";
+template <class VertexRange, class WeightKernel>
+Surface_mesh projection(Surface_mesh&& mesh, const VertexRange& vertices,
+						const SM_kd_tree& points, const Surface_mesh_normal_map& normals,
+						APSS_statistics* statistics, const WeightKernel& weight_kernel)
+{
+	project(mesh, vertices, points, normals, statistics, weight_kernel);
 
-	for(auto v : vertices)
-	{
-		auto [point, normal] = APSS(result.point(v), points, normals);
-		result.point(v)		 = point;
-		// result_normal[vi]	 = normal;
-	}
+	return std::move(mesh);
+}
+
+template <class VertexRange>
+void project(Surface_mesh& mesh, const VertexRange& vertices, const SM_kd_tree& points,
+			 const Surface_mesh_normal_map& normals, APSS_statistics* statistics,
+			 const Weight_kernel& weight_kernel)
+{
+	dispatch_weight_kernel(weight_kernel, [&](const auto& kernel) {
+		project(mesh, vertices, points, normals, statistics, kernel);
+	});
+}
+
+template <class VertexRange>
+Surface_mesh projection(const Surface_mesh& mesh, const VertexRange& vertices,
+						const SM_kd_tree& points, const Surface_mesh_normal_map& normals,
+						APSS_statistics* statistics, const Weight_kernel& weight_kernel)
+{
+	Surface_mesh result = mesh;
+	project(result, vertices, points, normals, statistics, weight_kernel);
 
 	return result;
 }
 
+template <class WeightKernel>
+void projection(Flat_mesh& mesh, const Flat_mesh& M2, const SM_kd_tree& M2_tree,
+				APSS_statistics* statistics, const WeightKernel& weight_kernel)
+{
+	APSS_statistics projection_statistics;
+	std::mutex statistics_mutex;
+
+	prepare_concurrent_queries(M2_tree);
+
+	Flat_mesh_neighbors neighbors{M2};
+
+	parallel_for_chunks(
+		mesh.size(),
+		[&](std::size_t begin, std::size_t end) {
+			APSS_statistics chunk_statistics;
+			APSS_neighborhood neighborhood;
+
+			for(std::size_t i = begin; i < end; ++i)
+			{
+				auto point = APSS_with_neighbors(mesh.point(i), M2_tree, neighbors, 20, 20,
+												 weight_kernel, {}, &chunk_statistics,
+												 neighborhood)
+								 .first;
+
+				mesh.x[i] = point[0];
+				mesh.y[i] = point[1];
+				mesh.z[i] = point[2];
+			}
+
+			std::lock_guard<std::mutex> lock(statistics_mutex);
+			projection_statistics += chunk_statistics;
+		},
+		64);
+
+	std::clog << "[STATUS] APSS : " << projection_statistics << '\n';
+
+	if(statistics)
+		*statistics += projection_statistics;
+}
+
+void projection(Flat_mesh& mesh, const Flat_mesh& M2, const SM_kd_tree& M2_tree,
+				APSS_statistics* statistics, const Weight_kernel& weight_kernel)
+{
+	dispatch_weight_kernel(weight_kernel, [&](const auto& kernel) {
+		projection(mesh, M2, M2_tree, statistics, kernel);
+	});
+}
+
 template <class VertexRange1, class VertexRange2>
 Surface_mesh projection(const Surface_mesh& M1, const VertexRange1& M1_vertices,
 						const Surface_mesh& M2, const VertexRange2& M2_vertices)
@@ -142,17 +396,16 @@ Surface_mesh projection(const Surface_mesh& M1, const VertexRange1& M1_vertices,
 	// Surface_mesh copy_m2 = M2;
 
 	// Calculating normals
-	auto [M2_normal_map, M2_exist] =
-		M2.property_map<Surface_mesh::Vertex_index, Kernel::Vector_3>("v:normal");
+	auto M2_normal_map = try_get_normal_map(M2);
 
-	if(!M2_exist)
+	if(!M2_normal_map)
 	{
 		// for(auto v : M2_vertices)
 		// {
 		// 	M2_normal_map[v] = CGAL::Polygon_mesh_processing::compute_vertex_normal(v, copy_m2);
 		// }
 
-		std::cerr << "[ERROR] in projection M2 do not have a vertex normal map\n";
+		std::cerr << "[ERROR] " << M2_normal_map.error() << '\n';
 		exit(EXIT_FAILURE);
 	}
 
@@ -160,7 +413,7 @@ Surface_mesh projection(const Surface_mesh& M1, const VertexRange1& M1_vertices,
 	SM_kd_tree kd_tree(M2_vertices.begin(), M2_vertices.end(), SM_kd_tree_splitter(),
 					   SM_kd_tree_traits_adapter(M2.points()));
 
-	return projection(M1, M1_vertices, kd_tree, M2_normal_map);
+	return projection(M1, M1_vertices, kd_tree, *M2_normal_map);
 }
 
 Surface_mesh projection(const Surface_mesh& M1, const Surface_mesh& M2)
@@ -168,4 +421,100 @@ Surface_mesh projection(const Surface_mesh& M1, const Surface_mesh& M2)
 	return projection(M1, M1.vertices(), M2, M2.vertices());
 }
 
+Result<Surface_mesh_normal_map> try_get_normal_map(const Surface_mesh& mesh)
+{
+	auto [normal_map, exist] =
+		mesh.property_map<Surface_mesh::Vertex_index, Kernel::Vector_3>("v:normal");
+
+	if(!exist)
+		return Error{"in projection M2 do not have a vertex normal map"};
+
+	return normal_map;
+}
+
+Status try_project(Surface_mesh& M1, const Surface_mesh& M2, SM_kd_tree_cache& kd_trees,
+				   const Weight_kernel& weight_kernel)
+{
+	if(M2.number_of_vertices() == 0)
+		return Error{"empty mesh"};
+
+	auto M2_normal_map = try_get_normal_map(M2);
+
+	if(!M2_normal_map)
+		return Error{M2_normal_map.error()};
+
+	project(M1, M1.vertices(), kd_trees.tree(M2), *M2_normal_map, nullptr, weight_kernel);
+
+	// Les positions de M1 ont changé : un arbre construit sur M1 n'est plus valide
+	kd_trees.invalidate(M1);
+
+	return {};
+}
+
+Result<Surface_mesh> try_projection(const Surface_mesh& M1, const Surface_mesh& M2,
+									SM_kd_tree_cache& kd_trees, const Weight_kernel& weight_kernel)
+{
+	Surface_mesh result = M1;
+
+	auto status = try_project(result, M2, kd_trees, weight_kernel);
+
+	if(!status)
+		return Error{status.error()};
+
+	return result;
+}
+
+Status try_project_points(const Surface_mesh& M1, const Surface_mesh& M2,
+						  SM_kd_tree_cache& kd_trees, std::vector<Kernel::Point_3>& projected_points,
+						  const Weight_kernel& weight_kernel)
+{
+	if(M2.number_of_vertices() == 0)
+		return Error{"empty mesh"};
+
+	auto M2_normal_map = try_get_normal_map(M2);
+
+	if(!M2_normal_map)
+		return Error{M2_normal_map.error()};
+
+	const SM_kd_tree& M2_tree = kd_trees.tree(M2);
+
+	projected_points.resize(M1.number_of_vertices());
+
+	dispatch_weight_kernel(weight_kernel, [&](const auto& kernel) {
+		project_points(M1, M1.vertices(), M2_tree, *M2_normal_map, projected_points.data(),
+					   nullptr, kernel);
+	});
+
+	return {};
+}
+
+void project(Surface_mesh& M1, const Surface_mesh& M2, SM_kd_tree_cache& kd_trees,
+			 const Weight_kernel& weight_kernel)
+{
+	auto status = try_project(M1, M2, kd_trees, weight_kernel);
+
+	if(!status)
+	{
+		std::cerr << "[ERROR] " << status.error() << '\n';
+		exit(EXIT_FAILURE);
+	}
+}
+
+Surface_mesh projection(const Surface_mesh& M1, const Surface_mesh& M2,
+						SM_kd_tree_cache& kd_trees, const Weight_kernel& weight_kernel)
+{
+	Surface_mesh result = M1;
+	project(result, M2, kd_trees, weight_kernel);
+
+	return result;
+}
+
+Surface_mesh projection(Surface_mesh&& M1, const Surface_mesh& M2, SM_kd_tree_cache& kd_trees,
+						const Weight_kernel& weight_kernel)
+{
+	project(M1, M2, kd_trees, weight_kernel);
+
+	return std::move(M1);
+}
+
 #endif // MESH_PROJECTION_INL
\ No newline at end of file
@@ -3,7 +3,57 @@
 
 #include "qglmesh.hpp"
 
+#include "chunking.hpp"
+#include "conversion.hpp"
+#include "packing.hpp"
+
+#include <QOpenGLContext>
+
+#include <algorithm>
 #include <iostream>
+#include <vector>
+
+// Constantes absentes des en-têtes OpenGL les plus anciens
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B
+#endif
+
+#ifndef GL_INT_2_10_10_10_REV
+#define GL_INT_2_10_10_10_REV 0x8D9F
+#endif
+
+namespace
+{
+
+// Alloue 'size' octets dans 'buffer' (qui doit être lié) et les remplit avec 'fill(data)'. Les
+// données sont écrites directement dans la mémoire du buffer quand elle peut être projetée
+// (glMapBuffer), sinon elles passent par une copie temporaire.
+template <class Fill>
+void allocate_and_fill(QOpenGLBuffer& buffer, int size, Fill&& fill)
+{
+	buffer.allocate(size);
+
+	if(void* data = buffer.map(QOpenGLBuffer::WriteOnly))
+	{
+		fill(data);
+		buffer.unmap();
+	}
+	else
+	{
+		std::vector<char> copy(static_cast<size_t>(size));
+		fill(static_cast<void*>(copy.data()));
+		buffer.write(0, copy.data(), size);
+	}
+}
+
+// Les maillages sans triangles sont dessinés comme des nuages de points (glDrawArrays)
+bool has_triangles(const Mesh_data& data)
+{
+	return data.positions.has_value() && data.triangulated_faces.has_value() &&
+		   !data.triangulated_faces->empty();
+}
+
+} // namespace
 
 QGLMesh::QGLMesh()
 	: vao(new QOpenGLVertexArrayObject()), texture(), positions(QOpenGLBuffer::VertexBuffer),
@@ -24,6 +74,27 @@ QGLMesh::QGLMesh(const Mesh_data& data, QOpenGLShaderProgram& shader_program) :
 }
 
 void QGLMesh::allocate(const Mesh_data& data)
+{
+	allocate(data, QImage());
+}
+
+void QGLMesh::allocate(const Mesh_data& data, const QImage& texture_image)
+{
+	// Les faces sont découpées en morceaux d'au plus 65535 sommets indexés sur 16 bits
+	if(has_triangles(data))
+	{
+		Chunked_mesh_data chunked = make_chunked_mesh_data(data);
+		allocate_vertices(chunked.data, texture_image);
+		allocate_chunks(chunked);
+	}
+	else
+	{
+		allocate_vertices(data, texture_image);
+		std::cerr << "[WARNING] No triangulated_faces buffer allocated\n";
+	}
+}
+
+void QGLMesh::allocate_vertices(const Mesh_data& data, const QImage& texture_image)
 {
 	std::cerr << "[DEBUG] Allocating vertex array object...\n";
 	vao->create();
@@ -101,41 +172,154 @@ void QGLMesh::allocate(const Mesh_data& data)
 			std::cerr << "[WARNING] No texcoords buffer allocated\n";
 		}
 
-		if(data.texture_path.has_value())
+		if(!texture_image.isNull())
+		{
+			allocate_texture(texture_image);
+		}
+		else if(data.texture_path.has_value())
+		{
+			allocate_texture(data.texture_path.value());
+		}
+		else
+		{
+			std::cerr << "[WARNING] No texture allocated\n";
+		}
+
+	}
+	vao->release();
+}
+
+void QGLMesh::allocate(const Mapped_mesh& mesh)
+{
+	allocate(mesh, QImage());
+}
+
+void QGLMesh::allocate(const Mapped_mesh& mesh, const QImage& texture_image)
+{
+	m_interleaved		 = true;
+	m_number_of_vertices = mesh.number_of_vertices;
+	m_number_of_faces	 = mesh.number_of_faces;
+
+	auto layout = [&mesh](const Mapped_attribute& attribute) {
+		Attribute_layout attribute_layout;
+
+		if(!attribute.empty())
 		{
-			std::cerr << "[DEBUG] Loading texture from " << data.texture_path.value() << "...\n";
+			attribute_layout.type =
+				attribute.type == Mapped_attribute::Type::Float32 ? GL_FLOAT : GL_UNSIGNED_BYTE;
+			attribute_layout.offset		= static_cast<int>(attribute.offset(mesh.vertex_data));
+			attribute_layout.tuple_size = static_cast<int>(attribute.components);
+			attribute_layout.stride		= static_cast<int>(attribute.stride);
+		}
 
-			// QImage image_data = QImage(data.texture_path->c_str());
+		return attribute_layout;
+	};
 
-			// std::cerr << "[DEBUG] format wxh : " << image_data.width() << "x" << image_data.height() << '\n';
+	m_position_layout = layout(mesh.positions);
+	m_normal_layout	  = layout(mesh.normals);
+	m_color_layout	  = layout(mesh.colors);
+	m_texcoord_layout = layout(mesh.texcoords);
+
+	std::cerr << "[DEBUG] Allocating vertex array object...\n";
+	vao->create();
+	vao->bind();
+	{
+		std::cerr << "[DEBUG] Allocating interleaved buffer of " << m_number_of_vertices
+				  << " vertices...\n";
 
-            // texture.reset(new QOpenGLTexture(image_data.mirrored()));
-            texture.reset(new QOpenGLTexture(QImage(data.texture_path->c_str()).mirrored()));
+		// Les pages du fichier sont lues directement par le driver, sans copie intermédiaire
+		positions.create();
+		positions.bind();
+		positions.setUsagePattern(QOpenGLBuffer::StaticDraw);
+		positions.allocate(mesh.vertex_data,
+						   static_cast<int>(m_number_of_vertices * mesh.vertex_stride));
 
-			texture->generateMipMaps();
-			texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
-			texture->setMagnificationFilter(QOpenGLTexture::Linear);
-			texture->setWrapMode(QOpenGLTexture::Repeat);
+		if(!texture_image.isNull())
+		{
+			allocate_texture(texture_image);
 		}
-		else
+		else if(mesh.texture_path.has_value())
 		{
-			std::cerr << "[WARNING] No texture allocated\n";
+			allocate_texture(mesh.texture_path.value());
 		}
 
-		if(data.triangulated_faces.has_value())
+		if(m_number_of_faces > 0)
+		{
+			std::cerr << "[DEBUG] Allocating buffer of " << m_number_of_faces << " faces...\n";
+
+			int size = static_cast<int>(m_number_of_faces * 3 * sizeof(unsigned int));
+
+			triangulated_faces.create();
+			triangulated_faces.bind();
+
+			allocate_and_fill(triangulated_faces, size, [&mesh](void* indices) {
+				copy_triangles(mesh, static_cast<unsigned int*>(indices));
+			});
+		}
+		else
 		{
-			m_number_of_faces = data.triangulated_faces->size();
+			std::cerr << "[WARNING] No triangulated_faces buffer allocated\n";
+		}
+	}
+	vao->release();
+}
+
+void QGLMesh::allocate(const Surface_mesh& mesh, const QImage& texture_image)
+{
+	Interleaved_layout layout = interleaved_layout(mesh);
+
+	auto attribute_layout = [&layout](int offset, int tuple_size) {
+		Attribute_layout attribute;
+
+		if(offset >= 0)
+			attribute = {GL_FLOAT, offset, tuple_size, static_cast<int>(layout.stride)};
+
+		return attribute;
+	};
+
+	m_interleaved		 = true;
+	m_number_of_vertices = mesh.number_of_vertices();
+	m_number_of_faces	 = mesh.number_of_faces();
+
+	m_position_layout = attribute_layout(layout.position, 3);
+	m_normal_layout	  = attribute_layout(layout.normal, 3);
+	m_color_layout	  = attribute_layout(layout.color, 4);
+	m_texcoord_layout = attribute_layout(layout.texcoord, 2);
 
+	std::cerr << "[DEBUG] Allocating vertex array object...\n";
+	vao->create();
+	vao->bind();
+	{
+		std::cerr << "[DEBUG] Allocating interleaved buffer of " << m_number_of_vertices
+				  << " vertices...\n";
+
+		// Les sommets sont convertis directement dans la mémoire du buffer (cf. conversion.hpp)
+		positions.create();
+		positions.bind();
+		positions.setUsagePattern(QOpenGLBuffer::StaticDraw);
+
+		allocate_and_fill(positions, static_cast<int>(m_number_of_vertices * layout.stride),
+						  [&](void* vertices) {
+							  write_interleaved_vertices(mesh, layout, static_cast<char*>(vertices));
+						  });
+
+		if(!texture_image.isNull())
+			allocate_texture(texture_image);
+
+		if(m_number_of_faces > 0)
+		{
 			std::cerr << "[DEBUG] Allocating buffer of " << m_number_of_faces << " faces...\n";
 
 			triangulated_faces.create();
 			triangulated_faces.bind();
-			// triangulated_faces.setUsagePattern(QOpenGLBuffer::StaticDraw);
-			triangulated_faces.allocate(
-				data.triangulated_faces->data(),
-				static_cast<int>(
-					data.triangulated_faces->size() *
-					sizeof(decltype(data.triangulated_faces)::value_type::value_type)));
+
+			allocate_and_fill(
+				triangulated_faces,
+				static_cast<int>(m_number_of_faces * 3 * sizeof(unsigned int)),
+				[&](void* indices) {
+					// Les faces qui ne sont pas des triangles ne sont pas dessinées
+					m_number_of_faces = write_triangles(mesh, static_cast<unsigned int*>(indices));
+				});
 		}
 		else
 		{
@@ -145,45 +329,403 @@ void QGLMesh::allocate(const Mesh_data& data)
 	vao->release();
 }
 
+void QGLMesh::allocate_packed(const Mesh_data& data, const QImage& texture_image)
+{
+	if(!data.positions.has_value())
+	{
+		std::cerr << "[WARNING] No positions buffer allocated\n";
+		allocate(data, texture_image);
+		return;
+	}
+
+	if(has_triangles(data))
+	{
+		Chunked_mesh_data chunked = make_chunked_mesh_data(data);
+		allocate_packed_vertices(chunked.data, texture_image);
+		allocate_chunks(chunked);
+	}
+	else
+	{
+		allocate_packed_vertices(data, texture_image);
+		std::cerr << "[WARNING] No triangulated_faces buffer allocated\n";
+	}
+}
+
+Packed_layout QGLMesh::set_packed_layout(const Mesh_data& data)
+{
+	// GL_INT_2_10_10_10_REV n'est un type d'attribut de sommet qu'à partir d'OpenGL 3.3
+	QOpenGLContext* context = QOpenGLContext::currentContext();
+
+	bool packed_normals = context && (context->format().version() >= qMakePair(3, 3) ||
+									  context->hasExtension("GL_ARB_vertex_type_2_10_10_10_rev"));
+
+	Packed_layout layout = packed_layout(data, packed_normals);
+
+	auto attribute_layout = [&layout](int offset, GLenum type, int tuple_size) {
+		Attribute_layout attribute;
+
+		if(offset >= 0)
+			attribute = {type, offset, tuple_size, static_cast<int>(layout.stride)};
+
+		return attribute;
+	};
+
+	m_interleaved		 = true;
+	m_number_of_vertices = data.positions->size();
+
+	// Les attributs entiers sont normalisés par setAttributeBuffer (cf. enable_attribute)
+	m_position_layout = attribute_layout(layout.position, GL_FLOAT, 3);
+	m_normal_layout	  = attribute_layout(
+		  layout.normal,
+		  layout.normal_format == Packed_layout::Normal_format::Int_2_10_10_10 ? GL_INT_2_10_10_10_REV
+																			   : GL_BYTE,
+		  4);
+	m_color_layout	  = attribute_layout(layout.color, GL_UNSIGNED_BYTE, 4);
+	m_texcoord_layout = attribute_layout(
+		layout.texcoord,
+		layout.texcoord_format == Packed_layout::Texcoord_format::Half_float ? GL_HALF_FLOAT
+																			 : GL_UNSIGNED_SHORT,
+		2);
+
+	return layout;
+}
+
+void QGLMesh::allocate_packed_vertices(const Mesh_data& data, const QImage& texture_image)
+{
+	Packed_layout layout = set_packed_layout(data);
+
+	std::cerr << "[DEBUG] Allocating vertex array object...\n";
+	vao->create();
+	vao->bind();
+	{
+		std::cerr << "[DEBUG] Allocating packed buffer of " << m_number_of_vertices
+				  << " vertices (" << layout.stride << " bytes per vertex)...\n";
+
+		positions.create();
+		positions.bind();
+		positions.setUsagePattern(QOpenGLBuffer::StaticDraw);
+
+		allocate_and_fill(positions, static_cast<int>(m_number_of_vertices * layout.stride),
+						  [&](void* vertices) {
+							  pack_vertices(data, layout, static_cast<char*>(vertices));
+						  });
+
+		if(!texture_image.isNull())
+		{
+			allocate_texture(texture_image);
+		}
+		else if(data.texture_path.has_value())
+		{
+			allocate_texture(data.texture_path.value());
+		}
+
+	}
+	vao->release();
+}
+
+void QGLMesh::allocate_chunks(const Chunked_mesh_data& chunked)
+{
+	m_chunks		  = chunked.chunks;
+	m_number_of_faces = chunked.indices.size() / 3;
+
+	std::cerr << "[DEBUG] Allocating buffer of " << m_number_of_faces << " faces in "
+			  << m_chunks.size() << " chunk(s)...\n";
+
+	vao->bind();
+	{
+		triangulated_faces.create();
+		triangulated_faces.bind();
+		triangulated_faces.allocate(
+			chunked.indices.data(),
+			static_cast<int>(chunked.indices.size() * sizeof(std::uint16_t)));
+	}
+	vao->release();
+}
+
+const std::vector<Mesh_chunk>& QGLMesh::chunks() const
+{
+	return m_chunks;
+}
+
+void QGLMesh::allocate_staged(const Mesh_data& data, const QImage& texture_image, bool packed)
+{
+	// Les nuages de points ne sont pas découpés en morceaux : ils sont envoyés directement
+	if(!has_triangles(data))
+	{
+		if(packed)
+			allocate_packed(data, texture_image);
+		else
+			allocate(data, texture_image);
+
+		return;
+	}
+
+	m_staging.reset(new Staging());
+
+	Staging& staging = *m_staging;
+	staging.chunked	 = make_chunked_mesh_data(data);
+
+	const Mesh_data& vertices = staging.chunked.data;
+
+	m_chunks			 = staging.chunked.chunks;
+	m_number_of_vertices = vertices.positions->size();
+	m_number_of_faces	 = staging.chunked.indices.size() / 3;
+	m_uploaded_chunks	 = 0;
+
+	// Flux de sommets à recopier morceau par morceau : buffer, données et taille d'un sommet
+	struct Vertex_stream
+	{
+		QOpenGLBuffer QGLMesh::*buffer;
+		const char* data;
+		size_t vertex_size;
+	};
+
+	std::vector<Vertex_stream> streams;
+
+	// Les buffers sont alloués sans données (glBufferData avec un pointeur nul)
+	auto reserve = [](QOpenGLBuffer& buffer, size_t size) {
+		buffer.create();
+		buffer.bind();
+		buffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+		buffer.allocate(static_cast<int>(size));
+	};
+
+	std::cerr << "[DEBUG] Allocating vertex array object...\n";
+	vao->create();
+	vao->bind();
+	{
+		if(packed)
+		{
+			// L'empaquetage est fait une fois, seule la copie vers le GPU est étalée
+			Packed_layout layout = set_packed_layout(vertices);
+
+			staging.packed_vertices.resize(m_number_of_vertices * layout.stride);
+			pack_vertices(vertices, layout, staging.packed_vertices.data());
+
+			reserve(positions, staging.packed_vertices.size());
+			streams.push_back({&QGLMesh::positions, staging.packed_vertices.data(), layout.stride});
+		}
+		else
+		{
+			auto add_stream = [&](QOpenGLBuffer QGLMesh::*buffer, const auto& attribute) {
+				if(!attribute)
+					return;
+
+				size_t vertex_size = sizeof(attribute->front());
+
+				reserve(this->*buffer, attribute->size() * vertex_size);
+				streams.push_back(
+					{buffer, reinterpret_cast<const char*>(attribute->data()), vertex_size});
+			};
+
+			add_stream(&QGLMesh::positions, vertices.positions);
+			add_stream(&QGLMesh::normals, vertices.normals);
+			add_stream(&QGLMesh::colors, vertices.colors);
+			add_stream(&QGLMesh::texcoords, vertices.texcoords);
+		}
+
+		reserve(triangulated_faces, staging.chunked.indices.size() * sizeof(std::uint16_t));
+	}
+	vao->release();
+
+	// Texture allouée vide, ses lignes sont envoyées après la géométrie
+	staging.texture_image = texture_image;
+
+	if(staging.texture_image.isNull() && data.texture_path.has_value())
+		staging.texture_image = read_texture_image(data.texture_path.value());
+
+	if(!staging.texture_image.isNull())
+		allocate_texture_storage(staging.texture_image);
+
+	// Un morceau peut être affiché dès que ses sommets et ses index sont envoyés
+	const char* indices = reinterpret_cast<const char*>(staging.chunked.indices.data());
+
+	for(const auto& chunk : m_chunks)
+	{
+		for(const auto& stream : streams)
+		{
+			staging.ranges.push_back({stream.buffer,
+									  stream.data + chunk.first_vertex * stream.vertex_size,
+									  chunk.first_vertex * stream.vertex_size,
+									  chunk.number_of_vertices * stream.vertex_size, false});
+		}
+
+		staging.ranges.push_back({&QGLMesh::triangulated_faces,
+								  indices + chunk.first_index * sizeof(std::uint16_t),
+								  chunk.first_index * sizeof(std::uint16_t),
+								  chunk.number_of_indices * sizeof(std::uint16_t), true});
+	}
+
+	std::cerr << "[DEBUG] Staging " << m_number_of_vertices << " vertices and "
+			  << m_number_of_faces << " faces in " << m_chunks.size() << " chunk(s)...\n";
+}
+
+size_t QGLMesh::upload(QOpenGLFunctions& gl, size_t byte_budget)
+{
+	if(!m_staging)
+		return 0;
+
+	Staging& staging = *m_staging;
+	size_t sent		 = 0;
+
+	// Le buffer d'index fait partie de l'état du vertex array object
+	vao->bind();
+
+	while(sent < byte_budget && staging.next_range < staging.ranges.size())
+	{
+		const Upload_range& range = staging.ranges[staging.next_range];
+
+		size_t size = std::min(range.size - staging.range_offset, byte_budget - sent);
+
+		QOpenGLBuffer& buffer = this->*range.buffer;
+		buffer.bind();
+		buffer.write(static_cast<int>(range.offset + staging.range_offset),
+					 range.data + staging.range_offset, static_cast<int>(size));
+
+		sent += size;
+		staging.range_offset += size;
+
+		if(staging.range_offset == range.size)
+		{
+			staging.range_offset = 0;
+			++staging.next_range;
+
+			if(range.completes_chunk)
+				++m_uploaded_chunks;
+		}
+	}
+
+	vao->release();
+
+	// Lignes de la texture (au moins une par appel pour avancer)
+	const QImage& image = staging.texture_image;
+
+	if(!image.isNull() && staging.next_range == staging.ranges.size() && sent < byte_budget)
+	{
+		// Tailles en size_t comme le budget, converties en int seulement pour OpenGL
+		size_t row_size		  = static_cast<size_t>(image.bytesPerLine());
+		size_t remaining_rows = static_cast<size_t>(image.height() - staging.next_row);
+		size_t rows = std::min(std::max<size_t>(1, (byte_budget - sent) / row_size), remaining_rows);
+
+		texture->bind();
+		gl.glTexSubImage2D(GL_TEXTURE_2D, 0, 0, staging.next_row, image.width(),
+						   static_cast<int>(rows), GL_RGBA, GL_UNSIGNED_BYTE,
+						   image.constScanLine(staging.next_row));
+		texture->release();
+
+		sent += rows * row_size;
+		staging.next_row += static_cast<int>(rows);
+
+		if(staging.next_row == image.height())
+		{
+			texture->generateMipMaps();
+			texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
+		}
+	}
+
+	if(staging.next_range == staging.ranges.size() &&
+	   (image.isNull() || staging.next_row == image.height()))
+	{
+		std::cerr << "[DEBUG] Staged mesh uploaded\n";
+		m_staging.reset();
+	}
+
+	return sent;
+}
+
+bool QGLMesh::is_uploaded() const
+{
+	return !m_staging;
+}
+
+QImage read_texture_image(const std::string& texture_path)
+{
+	std::cerr << "[DEBUG] Loading texture from " << texture_path << "...\n";
+
+	// QOpenGLTexture convertit l'image en RGBA8888 avant l'envoi : la conversion est faite ici
+	return QImage(texture_path.c_str()).mirrored().convertToFormat(QImage::Format_RGBA8888);
+}
+
+void QGLMesh::allocate_texture(const std::string& texture_path)
+{
+	allocate_texture(read_texture_image(texture_path));
+}
+
+void QGLMesh::allocate_texture(const QImage& texture_image)
+{
+	std::cerr << "[DEBUG] Allocating texture of " << texture_image.width() << "x"
+			  << texture_image.height() << " pixels...\n";
+
+	texture.reset(new QOpenGLTexture(texture_image));
+
+	texture->generateMipMaps();
+	texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
+	texture->setMagnificationFilter(QOpenGLTexture::Linear);
+	texture->setWrapMode(QOpenGLTexture::Repeat);
+}
+
+void QGLMesh::allocate_texture_storage(const QImage& texture_image)
+{
+	std::cerr << "[DEBUG] Allocating texture storage of " << texture_image.width() << "x"
+			  << texture_image.height() << " pixels...\n";
+
+	texture.reset(new QOpenGLTexture(QOpenGLTexture::Target2D));
+
+	texture->setSize(texture_image.width(), texture_image.height());
+	texture->setFormat(QOpenGLTexture::RGBA8_UNorm);
+	texture->setMipLevels(texture->maximumMipLevels());
+	texture->allocateStorage(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8);
+
+	// Les niveaux de mipmap ne sont générés qu'une fois l'image complète (cf. upload)
+	texture->setMinificationFilter(QOpenGLTexture::Linear);
+	texture->setMagnificationFilter(QOpenGLTexture::Linear);
+	texture->setWrapMode(QOpenGLTexture::Repeat);
+}
+
+void QGLMesh::enable_attribute(QOpenGLShaderProgram& shader_program, const char* name,
+							   QOpenGLBuffer& buffer, const Attribute_layout& layout)
+{
+	if(!buffer.isCreated() || layout.tuple_size == 0)
+		return;
+
+	std::cerr << "[DEBUG] Attribute : " << name << " enabled\n";
+	buffer.bind();
+	shader_program.enableAttributeArray(name);
+	// Qt normalise les attributs entiers (couleurs uchar ramenées dans [0, 1])
+	shader_program.setAttributeBuffer(name, layout.type, layout.offset, layout.tuple_size,
+									  layout.stride);
+}
+
 bool QGLMesh::use(QOpenGLShaderProgram& shader_program)
 {
 	if(shader_program.isLinked())
 	{
 		vao->bind();
 		{
-			if(positions.isCreated())
-			{
-				std::cerr << "[DEBUG] Attribute : position enabled\n";
-				positions.bind();
-				shader_program.enableAttributeArray("v_position");
-				shader_program.setAttributeBuffer("v_position", GL_FLOAT, 0, 3);
-			}
+			enable_attributes(shader_program, 0);
+		}
+		vao->release();
 
-			if(normals.isCreated())
-			{
-				std::cerr << "[DEBUG] Attribute : normal enabled\n";
-				normals.bind();
-				shader_program.enableAttributeArray("v_normal");
-				shader_program.setAttributeBuffer("v_normal", GL_FLOAT, 0, 3);
-			}
+		// Sans glDrawElementsBaseVertex (OpenGL 3.2), chaque morceau a son vertex array object
+		// dont les attributs commencent au premier sommet du morceau
+		m_chunk_vaos.resize(m_chunks.size());
 
-			if(colors.isCreated())
+		for(size_t c = 0; c < m_chunks.size(); ++c)
+		{
+			if(!m_chunk_vaos[c])
 			{
-				std::cerr << "[DEBUG] Attribute : color enabled\n";
-				colors.bind();
-				shader_program.enableAttributeArray("v_color");
-				shader_program.setAttributeBuffer("v_color", GL_FLOAT, 0, 4);
+				m_chunk_vaos[c].reset(new QOpenGLVertexArrayObject());
+				m_chunk_vaos[c]->create();
 			}
 
-			if(texcoords.isCreated())
+			m_chunk_vaos[c]->bind();
 			{
-				std::cerr << "[DEBUG] Attribute : texcoords enabled\n";
-				texcoords.bind();
-				shader_program.enableAttributeArray("v_texcoord");
-				shader_program.setAttributeBuffer("v_texcoord", GL_FLOAT, 0, 2);
+				enable_attributes(shader_program, m_chunks[c].first_vertex);
+				triangulated_faces.bind();
 			}
+			m_chunk_vaos[c]->release();
 		}
-		vao->release();
+
 		return true;
 	}
 	else
@@ -192,14 +734,104 @@ bool QGLMesh::use(QOpenGLShaderProgram& shader_program)
 	}
 }
 
-void QGLMesh::draw(QOpenGLFunctions& gl, QOpenGLShaderProgram& shader_program, GLenum mode)
+void QGLMesh::enable_attributes(QOpenGLShaderProgram& shader_program, size_t first_vertex)
+{
+	// Décalage d'un attribut pour commencer au sommet 'first_vertex' (les buffers non entrelacés
+	// ne contiennent que des float)
+	auto shifted = [first_vertex](Attribute_layout layout) {
+		size_t vertex_size = layout.stride != 0 ? static_cast<size_t>(layout.stride)
+												: layout.tuple_size * sizeof(float);
+		layout.offset += static_cast<int>(first_vertex * vertex_size);
+		return layout;
+	};
+
+	enable_attribute(shader_program, "v_position", positions, shifted(m_position_layout));
+	enable_attribute(shader_program, "v_normal", m_interleaved ? positions : normals,
+					 shifted(m_normal_layout));
+	enable_attribute(shader_program, "v_color", m_interleaved ? positions : colors,
+					 shifted(m_color_layout));
+	enable_attribute(shader_program, "v_texcoord", m_interleaved ? positions : texcoords,
+					 shifted(m_texcoord_layout));
+}
+
+void QGLMesh::set_bounding_box(const Mesh_data::vec_3f& min, const Mesh_data::vec_3f& max)
+{
+	m_min = min;
+	m_max = max;
+}
+
+std::array<Mesh_data::vec_3f, 2> QGLMesh::bounding_box() const
+{
+	return {m_min, m_max};
+}
+
+size_t QGLMesh::number_of_faces() const
+{
+	return m_number_of_faces;
+}
+
+void QGLMesh::bind_texture(QOpenGLShaderProgram& shader_program)
+{
+	if(texture)
+	{
+		shader_program.setUniformValue("f_texture", texture->textureId());
+		texture->bind(texture->textureId());
+	}
+}
+
+Culling_statistics QGLMesh::draw(QOpenGLFunctions& gl, QOpenGLShaderProgram& shader_program,
+								 GLenum mode, const Frustum* frustum)
 {
-    if(texture)
+    Culling_statistics statistics;
+
+    size_t number_of_chunks = std::max<size_t>(m_chunks.size(), 1);
+
+    if(frustum && !intersects(*frustum, m_min, m_max))
     {
-        shader_program.setUniformValue("f_texture", texture->textureId());
-        texture->bind(texture->textureId());
+        statistics.culled_triangles = m_number_of_faces;
+        statistics.culled_chunks    = number_of_chunks;
+        return statistics;
+    }
+
+    bind_texture(shader_program);
+
+    // Index sur 16 bits relatifs au premier sommet de chaque morceau
+    if(!m_chunks.empty())
+    {
+        // Le buffer d'index ne peut être lu qu'au travers des vertex array objects des
+        // morceaux : rien n'est dessiné tant que use() ne les a pas créés
+        if(m_chunk_vaos.size() != m_chunks.size())
+            return statistics;
+
+        // Pendant un envoi étalé (cf. upload), seuls les morceaux complets sont dessinés
+        size_t number_of_drawable_chunks = m_staging ? m_uploaded_chunks : m_chunks.size();
+
+        for(size_t c = 0; c < number_of_drawable_chunks; ++c)
+        {
+            const Mesh_chunk& chunk = m_chunks[c];
+
+            if(frustum && !intersects(*frustum, chunk.min, chunk.max))
+            {
+                statistics.culled_triangles += chunk.number_of_indices / 3;
+                ++statistics.culled_chunks;
+                continue;
+            }
+
+            m_chunk_vaos[c]->bind();
+            gl.glDrawElements(mode, static_cast<int>(chunk.number_of_indices),
+                              GL_UNSIGNED_SHORT,
+                              reinterpret_cast<const void*>(chunk.first_index *
+                                                            sizeof(std::uint16_t)));
+            m_chunk_vaos[c]->release();
+
+            statistics.drawn_triangles += chunk.number_of_indices / 3;
+            ++statistics.drawn_chunks;
+        }
+
+        return statistics;
     }
 
+    // Maillages non découpés : index sur 32 bits
     vao->bind();
     {
         if(triangulated_faces.isCreated())
@@ -212,6 +844,11 @@ void QGLMesh::draw(QOpenGLFunctions& gl, QOpenGLShaderProgram& shader_program, G
         }
     }
     vao->release();
+
+    statistics.drawn_triangles = m_number_of_faces;
+    statistics.drawn_chunks    = number_of_chunks;
+
+    return statistics;
 }
 
 
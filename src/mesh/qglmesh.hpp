@@ -1,10 +1,16 @@
 #ifndef QGLMESH_HPP
 #define QGLMESH_HPP
 
+#include "../instance/Surface_mesh.hpp"
+#include "chunking.hpp"
+#include "culling.hpp"
 #include "data.hpp"
+#include "mapping.hpp"
+#include "packing.hpp"
 
 // QT5
 
+#include <QImage>
 #include <QOpenGLBuffer>
 #include <QOpenGLShader>
 #include <QOpenGLShaderProgram>
@@ -13,7 +19,15 @@
 
 // STD
 
+#include <array>
+#include <limits>
 #include <memory>
+#include <string>
+#include <vector>
+
+// Décode une texture et la prépare pour OpenGL (retournée verticalement, format RGBA8888). Cette
+// fonction n'utilise pas de contexte OpenGL et peut être appelée depuis n'importe quel thread.
+QImage read_texture_image(const std::string& texture_path);
 
 // Structure utilisé pour transmettre les données d'un maillage à OpenGL pour l'affichage
 class QGLMesh
@@ -35,19 +49,137 @@ class QGLMesh
 	QGLMesh(const Mesh_data& data);
 	QGLMesh(const Mesh_data& data, QOpenGLShaderProgram& shader_program);
 
-	// allocate data on gpu
+	// allocate data on gpu : faces are split in spatially coherent chunks of at most 65535
+	// vertices with 16 bits indices (cf. make_chunked_mesh_data)
 	void allocate(const Mesh_data& data);
 
+	// same as allocate(data) but the texture is uploaded from an already decoded image
+	// (cf. read_texture_image) instead of being read from data.texture_path
+	void allocate(const Mesh_data& data, const QImage& texture_image);
+
+	// allocate mapped data on gpu : the interleaved vertex block of the file is uploaded as is
+	// in 'positions' and the other attributes point inside it (only the indices are repacked)
+	void allocate(const Mapped_mesh& mesh);
+	void allocate(const Mapped_mesh& mesh, const QImage& texture_image);
+
+	// same as allocate(data, texture_image) but in a single interleaved buffer with compact
+	// attribute formats (cf. packing.hpp) : 24 bytes per vertex instead of 48
+	void allocate_packed(const Mesh_data& data, const QImage& texture_image = QImage());
+
+	// staged allocation : buffers and texture are allocated empty and their content is sent by
+	// successive calls to upload, chunk after chunk, so that a large mesh does not block the
+	// thread owning the context. Only the chunks already uploaded are drawn.
+	void allocate_staged(const Mesh_data& data, const QImage& texture_image = QImage(),
+						 bool packed = false);
+
+	// send at most about 'byte_budget' bytes of the staged data (at least one texture row),
+	// returns the number of bytes sent. The context must be current.
+	size_t upload(QOpenGLFunctions& gl, size_t byte_budget);
+
+	// false while staged data remains to be uploaded
+	bool is_uploaded() const;
+
+	// allocate a surface mesh on gpu without intermediate Mesh_data : vertices are converted
+	// straight into an interleaved buffer (cf. write_interleaved_vertices)
+	void allocate(const Surface_mesh& mesh, const QImage& texture_image = QImage());
+
 	// use shader program for rendering
 	bool use(QOpenGLShaderProgram& shader_program);
 
-	// program must be bound before draw
-    void draw(QOpenGLFunctions& gl, QOpenGLShaderProgram& shader_program, GLenum mode = GL_TRIANGLES);
+	// chunks of the mesh (empty for mapped and surface meshes, drawn with 32 bits indices)
+	const std::vector<Mesh_chunk>& chunks() const;
+
+	// bounding box of the whole mesh, tested against the frustum before its chunks in draw
+	void set_bounding_box(const Mesh_data::vec_3f& min, const Mesh_data::vec_3f& max);
+	std::array<Mesh_data::vec_3f, 2> bounding_box() const;
+
+	size_t number_of_faces() const;
+
+	// bind the texture of the mesh (if any), also used to draw simplified versions of the mesh
+	// allocated without texture
+	void bind_texture(QOpenGLShaderProgram& shader_program);
+
+	// program must be bound before draw. If 'frustum' is given, the mesh (and each of its chunks)
+	// is only drawn when its bounding box intersects it.
+	Culling_statistics draw(QOpenGLFunctions& gl, QOpenGLShaderProgram& shader_program,
+							GLenum mode = GL_TRIANGLES, const Frustum* frustum = nullptr);
 
 
   protected:
-	size_t m_number_of_vertices;
-	size_t m_number_of_faces;
+	// Position of an attribute in its buffer (glVertexAttribPointer parameters)
+	struct Attribute_layout
+	{
+		GLenum type	   = GL_FLOAT;
+		int offset	   = 0;
+		int tuple_size = 0;
+		int stride	   = 0;
+	};
+
+	void allocate_vertices(const Mesh_data& data, const QImage& texture_image);
+	void allocate_packed_vertices(const Mesh_data& data, const QImage& texture_image);
+
+	// set the attribute layouts of the packed interleaved format of 'data' (cf. packing.hpp)
+	Packed_layout set_packed_layout(const Mesh_data& data);
+	void allocate_chunks(const Chunked_mesh_data& chunked);
+
+	void allocate_texture(const std::string& texture_path);
+	void allocate_texture(const QImage& texture_image);
+
+	// allocate an empty texture of the size of 'texture_image' (filled by upload)
+	void allocate_texture_storage(const QImage& texture_image);
+
+	void enable_attribute(QOpenGLShaderProgram& shader_program, const char* name,
+						  QOpenGLBuffer& buffer, const Attribute_layout& layout);
+
+	// enable all attributes, starting at vertex 'first_vertex' of the buffers
+	void enable_attributes(QOpenGLShaderProgram& shader_program, size_t first_vertex);
+
+	size_t m_number_of_vertices = 0;
+	size_t m_number_of_faces	= 0;
+
+	// All attributes are read from 'positions' when vertices are interleaved
+	bool m_interleaved = false;
+
+	Attribute_layout m_position_layout = {GL_FLOAT, 0, 3, 0};
+	Attribute_layout m_normal_layout   = {GL_FLOAT, 0, 3, 0};
+	Attribute_layout m_color_layout	   = {GL_FLOAT, 0, 4, 0};
+	Attribute_layout m_texcoord_layout = {GL_FLOAT, 0, 2, 0};
+
+	// Bounding box of the mesh, infinite until set_bounding_box is called (never culled)
+	Mesh_data::vec_3f m_min = {std::numeric_limits<float>::lowest(),
+							   std::numeric_limits<float>::lowest(),
+							   std::numeric_limits<float>::lowest()};
+	Mesh_data::vec_3f m_max = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+							   std::numeric_limits<float>::max()};
+
+	std::vector<Mesh_chunk> m_chunks;
+	std::vector<std::unique_ptr<QOpenGLVertexArrayObject>> m_chunk_vaos;
+
+	// Part of a buffer to write during a staged upload
+	struct Upload_range
+	{
+		QOpenGLBuffer QGLMesh::*buffer; // member pointer : meshes are moved inside vectors
+		const char* data;
+		size_t offset;
+		size_t size;
+		bool completes_chunk; // last range of a chunk (its indices)
+	};
+
+	// Data kept until the end of a staged upload
+	struct Staging
+	{
+		Chunked_mesh_data chunked;
+		std::vector<char> packed_vertices;
+		QImage texture_image;
+
+		std::vector<Upload_range> ranges;
+		size_t next_range	= 0;
+		size_t range_offset = 0; // bytes of ranges[next_range] already sent
+		int next_row		= 0; // next texture row to send
+	};
+
+	std::unique_ptr<Staging> m_staging;
+	size_t m_uploaded_chunks = 0;
 };
 
 // #include "qglmesh.inl"
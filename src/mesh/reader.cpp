@@ -0,0 +1,1381 @@
+#include "reader.hpp"
+
+// PROJECT
+
+#include "parallel.hpp"
+
+// STD
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+// Lecture par blocs d'un flux binaire : évite un appel à std::istream::read par valeur lue
+class Block_reader
+{
+  public:
+	explicit Block_reader(std::istream& stream, size_t block_size = 1 << 20)
+		: m_stream(stream), m_block(block_size)
+	{}
+
+	bool read(char* data, size_t size)
+	{
+		while(size > 0)
+		{
+			if(m_begin == m_end && !fill())
+				return false;
+
+			size_t n = std::min(size, m_end - m_begin);
+			std::memcpy(data, m_block.data() + m_begin, n);
+
+			m_begin += n;
+			data += n;
+			size -= n;
+		}
+
+		return true;
+	}
+
+  protected:
+	bool fill()
+	{
+		m_stream.read(m_block.data(), static_cast<std::streamsize>(m_block.size()));
+
+		m_begin = 0;
+		m_end	= static_cast<size_t>(m_stream.gcount());
+
+		return m_end > 0;
+	}
+
+	std::istream& m_stream;
+	std::vector<char> m_block;
+
+	size_t m_begin = 0;
+	size_t m_end   = 0;
+};
+
+std::string extension_of(const std::string& filename)
+{
+	auto n = filename.find_last_of('.');
+
+	if(n == std::string::npos)
+		return "";
+
+	std::string extension = filename.substr(n + 1);
+	std::transform(extension.begin(), extension.end(), extension.begin(),
+				   [](unsigned char c) { return std::tolower(c); });
+
+	return extension;
+}
+
+// Même convention que find_texture_path : le nom est relatif au dossier du fichier
+std::string path_in_directory_of(const std::string& filename, const std::string& name)
+{
+	auto n = filename.find_last_of("/\\");
+
+	if(n == std::string::npos)
+		return name;
+
+	return filename.substr(0, n) + '/' + name;
+}
+
+// Retire le '\r' des fichiers écrits sous windows
+void strip_carriage_return(std::string& line)
+{
+	if(!line.empty() && line.back() == '\r')
+		line.pop_back();
+}
+
+bool is_little_endian()
+{
+	const std::uint16_t value = 1;
+	unsigned char first_byte;
+	std::memcpy(&first_byte, &value, 1);
+	return first_byte == 1;
+}
+
+////// PLY
+
+enum class Ply_format
+{
+	Ascii,
+	Binary_little_endian,
+	Binary_big_endian
+};
+
+enum class Ply_type
+{
+	Int8,
+	Uint8,
+	Int16,
+	Uint16,
+	Int32,
+	Uint32,
+	Float32,
+	Float64,
+	Invalid
+};
+
+// Attribut de Mesh_data alimenté par une propriété de l'élément 'vertex'
+enum class Ply_target
+{
+	X,
+	Y,
+	Z,
+	Nx,
+	Ny,
+	Nz,
+	Red,
+	Green,
+	Blue,
+	Alpha,
+	S,
+	T,
+	None
+};
+
+// Composante d'un attribut désignée par 'target' dans le groupe de cibles qui commence à 'first'
+// (ex: ply_component(Ply_target::Ny, Ply_target::Nx) == 1)
+std::size_t ply_component(Ply_target target, Ply_target first)
+{
+	return static_cast<std::size_t>(target) - static_cast<std::size_t>(first);
+}
+
+// Opérations sur des tailles lues dans un en-tête : renvoient faux (sans modifier 'result') si le
+// résultat ne tient pas dans un size_t
+bool checked_multiply(size_t a, size_t b, size_t& result)
+{
+	if(b != 0 && a > std::numeric_limits<size_t>::max() / b)
+		return false;
+
+	result = a * b;
+	return true;
+}
+
+bool checked_add(size_t a, size_t b, size_t& result)
+{
+	if(a > std::numeric_limits<size_t>::max() - b)
+		return false;
+
+	result = a + b;
+	return true;
+}
+
+struct Ply_property
+{
+	std::string name;
+	Ply_type type		= Ply_type::Invalid;
+	Ply_type count_type = Ply_type::Invalid; // type du nombre d'éléments pour les listes
+	bool is_list		= false;
+	Ply_target target	= Ply_target::None;
+};
+
+struct Ply_element
+{
+	std::string name;
+	size_t count = 0;
+	std::vector<Ply_property> properties;
+};
+
+Ply_type ply_type(const std::string& name)
+{
+	if(name == "char" || name == "int8")
+		return Ply_type::Int8;
+	if(name == "uchar" || name == "uint8")
+		return Ply_type::Uint8;
+	if(name == "short" || name == "int16")
+		return Ply_type::Int16;
+	if(name == "ushort" || name == "uint16")
+		return Ply_type::Uint16;
+	if(name == "int" || name == "int32")
+		return Ply_type::Int32;
+	if(name == "uint" || name == "uint32")
+		return Ply_type::Uint32;
+	if(name == "float" || name == "float32")
+		return Ply_type::Float32;
+	if(name == "double" || name == "float64")
+		return Ply_type::Float64;
+
+	return Ply_type::Invalid;
+}
+
+size_t ply_type_size(Ply_type type)
+{
+	switch(type)
+	{
+		case Ply_type::Int8:
+		case Ply_type::Uint8:
+			return 1;
+		case Ply_type::Int16:
+		case Ply_type::Uint16:
+			return 2;
+		case Ply_type::Int32:
+		case Ply_type::Uint32:
+		case Ply_type::Float32:
+			return 4;
+		case Ply_type::Float64:
+			return 8;
+		default:
+			return 0;
+	}
+}
+
+// Vérifie que les nombres d'éléments de l'en-tête peuvent tenir dans les 'data_size' octets qui le
+// suivent, avant que les tableaux ne soient alloués à ces tailles. Un élément occupe au moins la
+// taille de ses propriétés en binaire (une liste vide n'occupe que son nombre de valeurs) et au
+// moins un caractère et un séparateur par propriété en ascii.
+bool ply_elements_fit(const std::vector<Ply_element>& elements, Ply_format format,
+					  size_t data_size)
+{
+	size_t required = 0;
+
+	for(const auto& element : elements)
+	{
+		size_t element_size = 0;
+
+		for(const auto& property : element.properties)
+		{
+			if(format == Ply_format::Ascii)
+				element_size += 2;
+			else
+				element_size += ply_type_size(property.is_list ? property.count_type : property.type);
+		}
+
+		// La dernière ligne d'un fichier ascii peut ne pas avoir de séparateur final
+		if(format == Ply_format::Ascii && element_size > 0)
+			--element_size;
+
+		size_t element_block_size = 0;
+
+		if(!checked_multiply(element.count, std::max<size_t>(element_size, 1), element_block_size) ||
+		   !checked_add(required, element_block_size, required))
+			return false;
+	}
+
+	return required <= data_size;
+}
+
+// Facteur appliqué aux couleurs entières pour les ramener dans [0, 1]
+float ply_color_scale(Ply_type type)
+{
+	switch(type)
+	{
+		case Ply_type::Uint8:
+			return 1.0f / 255.0f;
+		case Ply_type::Uint16:
+			return 1.0f / 65535.0f;
+		default:
+			return 1.0f;
+	}
+}
+
+Ply_target ply_vertex_target(const std::string& name)
+{
+	if(name == "x")
+		return Ply_target::X;
+	if(name == "y")
+		return Ply_target::Y;
+	if(name == "z")
+		return Ply_target::Z;
+	if(name == "nx")
+		return Ply_target::Nx;
+	if(name == "ny")
+		return Ply_target::Ny;
+	if(name == "nz")
+		return Ply_target::Nz;
+	if(name == "red" || name == "r" || name == "diffuse_red")
+		return Ply_target::Red;
+	if(name == "green" || name == "g" || name == "diffuse_green")
+		return Ply_target::Green;
+	if(name == "blue" || name == "b" || name == "diffuse_blue")
+		return Ply_target::Blue;
+	if(name == "alpha" || name == "a" || name == "diffuse_alpha")
+		return Ply_target::Alpha;
+	if(name == "s" || name == "u" || name == "texture_u" || name == "texture_s")
+		return Ply_target::S;
+	if(name == "t" || name == "v" || name == "texture_v" || name == "texture_t")
+		return Ply_target::T;
+
+	return Ply_target::None;
+}
+
+// Décode une valeur binaire en inversant ses octets si l'endianness diffère de la machine
+double decode_ply_value(const char* data, Ply_type type, bool swap)
+{
+	char bytes[8];
+	size_t size = ply_type_size(type);
+
+	std::memcpy(bytes, data, size);
+
+	if(swap)
+		std::reverse(bytes, bytes + size);
+
+	switch(type)
+	{
+		case Ply_type::Int8:
+		{
+			std::int8_t value;
+			std::memcpy(&value, bytes, size);
+			return value;
+		}
+		case Ply_type::Uint8:
+		{
+			std::uint8_t value;
+			std::memcpy(&value, bytes, size);
+			return value;
+		}
+		case Ply_type::Int16:
+		{
+			std::int16_t value;
+			std::memcpy(&value, bytes, size);
+			return value;
+		}
+		case Ply_type::Uint16:
+		{
+			std::uint16_t value;
+			std::memcpy(&value, bytes, size);
+			return value;
+		}
+		case Ply_type::Int32:
+		{
+			std::int32_t value;
+			std::memcpy(&value, bytes, size);
+			return value;
+		}
+		case Ply_type::Uint32:
+		{
+			std::uint32_t value;
+			std::memcpy(&value, bytes, size);
+			return value;
+		}
+		case Ply_type::Float32:
+		{
+			float value;
+			std::memcpy(&value, bytes, size);
+			return static_cast<double>(value);
+		}
+		case Ply_type::Float64:
+		{
+			double value;
+			std::memcpy(&value, bytes, size);
+			return value;
+		}
+		default:
+			return 0;
+	}
+}
+
+// Source des valeurs d'un élément PLY, ascii (une ligne par élément) ou binaire. 'data_size' est
+// le nombre d'octets du fichier après l'en-tête : il borne les tailles de listes lues.
+class Ply_value_reader
+{
+  public:
+	Ply_value_reader(std::istream& stream, Ply_format format, size_t data_size)
+		: m_stream(stream), m_blocks(stream), m_format(format),
+		  m_swap((format == Ply_format::Binary_little_endian) != is_little_endian()),
+		  m_data_size(data_size)
+	{}
+
+	// Passe à l'élément suivant (lit la ligne suivante en ascii)
+	bool next_element()
+	{
+		if(m_format != Ply_format::Ascii)
+			return true;
+
+		do
+		{
+			if(!std::getline(m_stream, m_line))
+				return false;
+		} while(m_line.find_first_not_of(" \t\r") == std::string::npos);
+
+		m_cursor = m_line.c_str();
+		return true;
+	}
+
+	bool read(Ply_type type, double& value)
+	{
+		if(m_format == Ply_format::Ascii)
+		{
+			char* end = nullptr;
+			value	  = std::strtod(m_cursor, &end);
+
+			if(end == m_cursor)
+				return false;
+
+			m_cursor = end;
+			return true;
+		}
+
+		char bytes[8];
+
+		if(!m_blocks.read(bytes, ply_type_size(type)))
+			return false;
+
+		value = decode_ply_value(bytes, type, m_swap);
+		return true;
+	}
+
+	// Lit le nombre de valeurs d'une liste. Renvoie faux si ce n'est pas un entier positif ou si
+	// les valeurs ne peuvent pas tenir dans le reste du fichier (au moins un octet par valeur en
+	// ascii, la taille du type en binaire) : la taille est vérifiée avant toute conversion.
+	bool read_list_count(const Ply_property& property, size_t& count)
+	{
+		double value = 0;
+
+		if(!read(property.count_type, value))
+			return false;
+
+		size_t value_size = m_format == Ply_format::Ascii ? 1 : ply_type_size(property.type);
+
+		if(!(value >= 0) || value != std::floor(value) ||
+		   value > static_cast<double>(m_data_size / value_size))
+			return false;
+
+		count = static_cast<size_t>(value);
+		return true;
+	}
+
+  protected:
+	std::istream& m_stream;
+	Block_reader m_blocks;
+	Ply_format m_format;
+	bool m_swap;
+	size_t m_data_size;
+
+	std::string m_line;
+	const char* m_cursor = nullptr;
+};
+
+bool read_ply_header(std::istream& stream, const std::string& filename, Ply_format& format,
+					 std::vector<Ply_element>& elements, std::string& texture_name)
+{
+	std::string line;
+
+	if(!std::getline(stream, line) || (strip_carriage_return(line), line) != "ply")
+		return false;
+
+	bool has_format = false;
+
+	while(std::getline(stream, line))
+	{
+		strip_carriage_return(line);
+
+		std::istringstream tokens(line);
+		std::string keyword;
+		tokens >> keyword;
+
+		if(keyword == "format")
+		{
+			std::string name;
+			tokens >> name;
+
+			if(name == "ascii")
+				format = Ply_format::Ascii;
+			else if(name == "binary_little_endian")
+				format = Ply_format::Binary_little_endian;
+			else if(name == "binary_big_endian")
+				format = Ply_format::Binary_big_endian;
+			else
+				return false;
+
+			has_format = true;
+		}
+		else if(keyword == "comment")
+		{
+			std::string name;
+			tokens >> name;
+
+			if(name == "TextureFile")
+				tokens >> texture_name;
+		}
+		else if(keyword == "element")
+		{
+			Ply_element element;
+			tokens >> element.name >> element.count;
+
+			if(!tokens)
+				return false;
+
+			elements.push_back(std::move(element));
+		}
+		else if(keyword == "property")
+		{
+			if(elements.empty())
+				return false;
+
+			Ply_property property;
+			std::string type;
+			tokens >> type;
+
+			if(type == "list")
+			{
+				std::string count_type;
+				tokens >> count_type >> type;
+
+				property.is_list	= true;
+				property.count_type = ply_type(count_type);
+
+				if(property.count_type == Ply_type::Invalid)
+					return false;
+			}
+
+			property.type = ply_type(type);
+			tokens >> property.name;
+
+			if(property.type == Ply_type::Invalid || !tokens)
+				return false;
+
+			if(elements.back().name == "vertex" && !property.is_list)
+				property.target = ply_vertex_target(property.name);
+
+			elements.back().properties.push_back(std::move(property));
+		}
+		else if(keyword == "end_header")
+		{
+			return has_format;
+		}
+		else if(keyword != "obj_info" && !keyword.empty())
+		{
+			std::cerr << "[WARNING] read_ply : unknown header line '" << line << "' in "
+					  << filename << '\n';
+		}
+	}
+
+	return false;
+}
+
+bool read_ply_vertices(Ply_value_reader& reader, const Ply_element& element,
+					   Mesh_data& mesh_data)
+{
+	auto has_target = [&element](Ply_target target) {
+		return std::any_of(element.properties.begin(), element.properties.end(),
+						   [target](const Ply_property& p) { return p.target == target; });
+	};
+
+	if(!has_target(Ply_target::X) || !has_target(Ply_target::Y) || !has_target(Ply_target::Z))
+		return false;
+
+	auto& positions = mesh_data.positions.emplace(element.count, Mesh_data::vec_3f{0, 0, 0});
+
+	std::vector<Mesh_data::vec_3f>* normals	  = nullptr;
+	std::vector<Mesh_data::vec_4f>* colors	  = nullptr;
+	std::vector<Mesh_data::vec_2f>* texcoords = nullptr;
+
+	if(has_target(Ply_target::Nx))
+		normals = &mesh_data.normals.emplace(element.count, Mesh_data::vec_3f{0, 0, 0});
+
+	if(has_target(Ply_target::Red))
+		colors = &mesh_data.colors.emplace(element.count, Mesh_data::vec_4f{0, 0, 0, 1});
+
+	if(has_target(Ply_target::S))
+		texcoords = &mesh_data.texcoords.emplace(element.count, Mesh_data::vec_2f{0, 0});
+
+	for(size_t i = 0; i < element.count; ++i)
+	{
+		if(!reader.next_element())
+			return false;
+
+		for(const auto& property : element.properties)
+		{
+			double value = 0;
+
+			if(property.is_list)
+			{
+				size_t count = 0;
+
+				if(!reader.read_list_count(property, count))
+					return false;
+
+				for(size_t j = 0; j < count; ++j)
+				{
+					if(!reader.read(property.type, value))
+						return false;
+				}
+
+				continue;
+			}
+
+			if(!reader.read(property.type, value))
+				return false;
+
+			float f = static_cast<float>(value);
+
+			switch(property.target)
+			{
+				case Ply_target::X:
+					positions[i][0] = f;
+					break;
+				case Ply_target::Y:
+					positions[i][1] = f;
+					break;
+				case Ply_target::Z:
+					positions[i][2] = f;
+					break;
+				case Ply_target::Nx:
+				case Ply_target::Ny:
+				case Ply_target::Nz:
+					if(normals)
+						(*normals)[i][ply_component(property.target, Ply_target::Nx)] = f;
+					break;
+				case Ply_target::Red:
+				case Ply_target::Green:
+				case Ply_target::Blue:
+				case Ply_target::Alpha:
+					if(colors)
+						(*colors)[i][ply_component(property.target, Ply_target::Red)] =
+							f * ply_color_scale(property.type);
+					break;
+				case Ply_target::S:
+				case Ply_target::T:
+					if(texcoords)
+						(*texcoords)[i][ply_component(property.target, Ply_target::S)] = f;
+					break;
+				default:
+					break;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool read_ply_faces(Ply_value_reader& reader, const Ply_element& element,
+					size_t number_of_vertices, Mesh_data& mesh_data)
+{
+	auto& faces = mesh_data.triangulated_faces.emplace();
+	faces.reserve(element.count);
+
+	std::vector<unsigned int> polygon;
+
+	for(size_t i = 0; i < element.count; ++i)
+	{
+		if(!reader.next_element())
+			return false;
+
+		for(const auto& property : element.properties)
+		{
+			bool is_indices = property.is_list && (property.name == "vertex_indices" ||
+												   property.name == "vertex_index");
+			double value	= 0;
+
+			if(!property.is_list)
+			{
+				if(!reader.read(property.type, value))
+					return false;
+
+				continue;
+			}
+
+			size_t count = 0;
+
+			if(!reader.read_list_count(property, count))
+				return false;
+
+			polygon.clear();
+
+			for(size_t j = 0; j < count; ++j)
+			{
+				if(!reader.read(property.type, value))
+					return false;
+
+				if(!is_indices)
+					continue;
+
+				// Index vérifié avant sa conversion (négatif, non entier ou trop grand)
+				if(!(value >= 0) || value != std::floor(value) ||
+				   value >= static_cast<double>(number_of_vertices))
+				{
+					std::cerr << "[WARNING] read_ply : face " << i
+							  << " has an invalid vertex index\n";
+					return false;
+				}
+
+				polygon.push_back(static_cast<unsigned int>(value));
+			}
+
+			if(!is_indices)
+				continue;
+
+			// Triangulation en éventail
+			for(size_t j = 2; j < polygon.size(); ++j)
+				faces.push_back({polygon[0], polygon[j - 1], polygon[j]});
+		}
+	}
+
+	return true;
+}
+
+// Saute un élément inutilisé (valeurs lues puis ignorées)
+bool skip_ply_element(Ply_value_reader& reader, const Ply_element& element)
+{
+	for(size_t i = 0; i < element.count; ++i)
+	{
+		if(!reader.next_element())
+			return false;
+
+		for(const auto& property : element.properties)
+		{
+			double value = 0;
+			size_t count = 1;
+
+			if(property.is_list && !reader.read_list_count(property, count))
+				return false;
+
+			for(size_t j = 0; j < count; ++j)
+			{
+				if(!reader.read(property.type, value))
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Cherche l'attribut formé des propriétés 'targets' consécutives et de même type dans un élément
+// 'vertex' sans liste. Renvoie faux si elles existent mais ne sont pas contiguës.
+bool find_mapped_attribute(const Ply_element& element, const char* block,
+						   std::initializer_list<Ply_target> targets, size_t min_components,
+						   Mapped_attribute& attribute)
+{
+	size_t offset = 0;
+
+	for(size_t i = 0; i < element.properties.size(); ++i)
+	{
+		const auto& first = element.properties[i];
+
+		if(first.target != *targets.begin())
+		{
+			offset += ply_type_size(first.type);
+			continue;
+		}
+
+		unsigned components = 0;
+
+		for(auto target : targets)
+		{
+			size_t j = i + components;
+
+			if(j >= element.properties.size() || element.properties[j].target != target ||
+			   element.properties[j].type != first.type)
+				break;
+
+			++components;
+		}
+
+		if(components < min_components)
+			return false;
+
+		if(first.type == Ply_type::Float32)
+			attribute.type = Mapped_attribute::Type::Float32;
+		else if(first.type == Ply_type::Uint8)
+			attribute.type = Mapped_attribute::Type::Uint8;
+		else
+			return false;
+
+		attribute.data		 = block + offset;
+		attribute.components = components;
+		return true;
+	}
+
+	// Attribut absent
+	return true;
+}
+
+////// OBJ
+
+// Sommet créé pour un coin de face OBJ : les sommets partageant la même position sont chaînés pour
+// retrouver un triplet (position, texcoord, normale) déjà rencontré sans table de hachage.
+struct Obj_vertex
+{
+	int texcoord;
+	int normal;
+	unsigned int next;
+};
+
+constexpr unsigned int obj_no_vertex = std::numeric_limits<unsigned int>::max();
+
+// Convertit un index OBJ (à partir de 1, négatif s'il est relatif à la fin) en index à partir de 0
+long obj_index(long index, size_t size)
+{
+	return index < 0 ? static_cast<long>(size) + index : index - 1;
+}
+
+// Lit le premier nom de texture d'un fichier de matériaux (même ordre de recherche que assimp :
+// texture diffuse d'abord)
+std::string read_mtl_texture_name(const std::string& filename)
+{
+	std::ifstream stream(filename);
+	std::string line;
+	std::string texture_name;
+
+	while(std::getline(stream, line))
+	{
+		strip_carriage_return(line);
+
+		std::istringstream tokens(line);
+		std::string keyword;
+		tokens >> keyword;
+
+		if(keyword.rfind("map_", 0) != 0)
+			continue;
+
+		// Le nom de fichier est le dernier mot (les options comme -s 1 1 1 le précèdent)
+		std::string name;
+
+		while(tokens >> name)
+			;
+
+		if(keyword == "map_Kd")
+			return name;
+
+		if(texture_name.empty())
+			texture_name = name;
+	}
+
+	return texture_name;
+}
+
+} // namespace
+
+bool has_native_reader(const std::string& filename)
+{
+	auto extension = extension_of(filename);
+	return extension == "ply" || extension == "obj";
+}
+
+std::optional<Mesh_data> read_mesh_data(const std::string& filename)
+{
+	auto extension = extension_of(filename);
+
+	if(extension == "ply")
+		return read_ply(filename);
+
+	if(extension == "obj")
+		return read_obj(filename);
+
+	return std::nullopt;
+}
+
+std::optional<Mesh_data> read_ply(const std::string& filename)
+{
+	std::ifstream stream(filename, std::ios::binary);
+
+	if(!stream)
+	{
+		std::cerr << "[WARNING] read_ply : cannot open " << filename << '\n';
+		return std::nullopt;
+	}
+
+	Ply_format format = Ply_format::Ascii;
+	std::vector<Ply_element> elements;
+	std::string texture_name;
+
+	if(!read_ply_header(stream, filename, format, elements, texture_name))
+	{
+		std::cerr << "[WARNING] read_ply : unsupported header in " << filename << '\n';
+		return std::nullopt;
+	}
+
+	// Taille des données qui suivent l'en-tête
+	std::streamoff header_end = stream.tellg();
+	stream.seekg(0, std::ios::end);
+	std::streamoff file_end = stream.tellg();
+	stream.seekg(header_end);
+
+	if(header_end < 0 || file_end < header_end)
+	{
+		std::cerr << "[WARNING] read_ply : cannot determine the size of " << filename << '\n';
+		return std::nullopt;
+	}
+
+	size_t data_size = static_cast<size_t>(file_end - header_end);
+
+	if(!ply_elements_fit(elements, format, data_size))
+	{
+		std::cerr << "[WARNING] read_ply : element counts of " << filename
+				  << " exceed the size of the file\n";
+		return std::nullopt;
+	}
+
+	Mesh_data mesh_data;
+	Ply_value_reader reader(stream, format, data_size);
+
+	size_t number_of_vertices = 0;
+
+	for(const auto& element : elements)
+	{
+		bool success = true;
+
+		if(element.name == "vertex")
+		{
+			success			   = read_ply_vertices(reader, element, mesh_data);
+			number_of_vertices = element.count;
+		}
+		else if(element.name == "face")
+			success = read_ply_faces(reader, element, number_of_vertices, mesh_data);
+		else
+			success = skip_ply_element(reader, element);
+
+		if(!success)
+		{
+			std::cerr << "[WARNING] read_ply : cannot read element '" << element.name << "' of "
+					  << filename << '\n';
+			return std::nullopt;
+		}
+	}
+
+	if(!mesh_data.positions.has_value())
+	{
+		std::cerr << "[WARNING] read_ply : " << filename << " contains no vertices\n";
+		return std::nullopt;
+	}
+
+	if(!texture_name.empty())
+		mesh_data.texture_path = path_in_directory_of(filename, texture_name);
+
+	if(!mesh_data.normals.has_value())
+		compute_vertex_normals(mesh_data);
+
+	return mesh_data;
+}
+
+std::optional<Mapped_mesh> map_ply(const std::string& filename)
+{
+	if(extension_of(filename) != "ply" || !is_little_endian())
+		return std::nullopt;
+
+	Mapped_mesh mesh;
+	mesh.file = Mapped_file(filename);
+
+	if(!mesh.file.is_open())
+		return std::nullopt;
+
+	const char* data = mesh.file.data();
+	const size_t size = mesh.file.size();
+
+	// L'en-tête est une courte partie texte terminée par "end_header"
+	const char end_header[] = "end_header";
+	const char* header_limit = data + std::min<size_t>(size, 1 << 16);
+	const char* header_end	 = std::search(data, header_limit, end_header,
+										   end_header + sizeof(end_header) - 1);
+
+	if(header_end == header_limit)
+		return std::nullopt;
+
+	header_end = std::find(header_end, data + size, '\n');
+
+	if(header_end == data + size)
+		return std::nullopt;
+
+	++header_end;
+
+	std::istringstream header(std::string(data, header_end));
+
+	Ply_format format = Ply_format::Ascii;
+	std::vector<Ply_element> elements;
+	std::string texture_name;
+
+	if(!read_ply_header(header, filename, format, elements, texture_name) ||
+	   format != Ply_format::Binary_little_endian)
+		return std::nullopt;
+
+	if(elements.empty() || elements.size() > 2 || elements[0].name != "vertex" ||
+	   (elements.size() == 2 && elements[1].name != "face"))
+		return std::nullopt;
+
+	const auto& vertex = elements[0];
+
+	for(const auto& property : vertex.properties)
+	{
+		if(property.is_list)
+			return std::nullopt;
+
+		mesh.vertex_stride += ply_type_size(property.type);
+	}
+
+	mesh.vertex_data		= header_end;
+	mesh.number_of_vertices = vertex.count;
+
+	if(!find_mapped_attribute(vertex, mesh.vertex_data, {Ply_target::X, Ply_target::Y, Ply_target::Z},
+							  3, mesh.positions) ||
+	   !find_mapped_attribute(vertex, mesh.vertex_data,
+							  {Ply_target::Nx, Ply_target::Ny, Ply_target::Nz}, 3, mesh.normals) ||
+	   !find_mapped_attribute(
+		   vertex, mesh.vertex_data,
+		   {Ply_target::Red, Ply_target::Green, Ply_target::Blue, Ply_target::Alpha}, 3,
+		   mesh.colors) ||
+	   !find_mapped_attribute(vertex, mesh.vertex_data, {Ply_target::S, Ply_target::T}, 2,
+							  mesh.texcoords))
+		return std::nullopt;
+
+	// Positions, normales et coordonnées de texture doivent être des flottants. Sans normales dans
+	// le fichier, read_ply les calcule : la projection ne peut pas les fournir sans copie.
+	if(mesh.positions.empty() || mesh.positions.type != Mapped_attribute::Type::Float32 ||
+	   mesh.normals.empty() || mesh.normals.type != Mapped_attribute::Type::Float32 ||
+	   (!mesh.texcoords.empty() && mesh.texcoords.type != Mapped_attribute::Type::Float32))
+		return std::nullopt;
+
+	for(auto* attribute : {&mesh.positions, &mesh.normals, &mesh.colors, &mesh.texcoords})
+	{
+		attribute->stride = mesh.vertex_stride;
+		attribute->count  = attribute->empty() ? 0 : mesh.number_of_vertices;
+	}
+
+	// Les tailles viennent de l'en-tête : un débordement rendrait la vérification de la taille du
+	// fichier inopérante
+	size_t vertex_block_size = 0;
+	size_t expected_size	 = 0;
+
+	if(!checked_multiply(mesh.number_of_vertices, mesh.vertex_stride, vertex_block_size) ||
+	   !checked_add(static_cast<size_t>(header_end - data), vertex_block_size, expected_size))
+		return std::nullopt;
+
+	if(elements.size() == 2)
+	{
+		const auto& face = elements[1];
+
+		// Une seule liste (uchar, int/uint) de 3 index par face
+		if(face.properties.size() != 1 || !face.properties[0].is_list ||
+		   face.properties[0].count_type != Ply_type::Uint8 ||
+		   (face.properties[0].type != Ply_type::Int32 &&
+			face.properties[0].type != Ply_type::Uint32))
+			return std::nullopt;
+
+		mesh.face_stride	 = 1 + 3 * sizeof(std::uint32_t);
+		mesh.number_of_faces = face.count;
+
+		size_t face_block_size = 0;
+
+		if(!checked_multiply(mesh.number_of_faces, mesh.face_stride, face_block_size) ||
+		   !checked_add(expected_size, face_block_size, expected_size))
+			return std::nullopt;
+	}
+
+	// Une taille différente signifie des faces qui ne sont pas toutes des triangles
+	if(size != expected_size)
+		return std::nullopt;
+
+	if(elements.size() == 2)
+		mesh.face_data = mesh.vertex_data + vertex_block_size;
+
+	// Vérifie les faces (le GPU ne doit pas lire hors du bloc des sommets)
+	std::atomic<bool> valid_faces{true};
+
+	parallel_for_chunks(mesh.number_of_faces, [&](size_t begin, size_t end) {
+		for(size_t i = begin; i < end && valid_faces; ++i)
+		{
+			const char* face = mesh.face_data + i * mesh.face_stride;
+			std::uint32_t indices[3];
+			std::memcpy(indices, face + 1, sizeof(indices));
+
+			if(face[0] != 3 || indices[0] >= mesh.number_of_vertices ||
+			   indices[1] >= mesh.number_of_vertices || indices[2] >= mesh.number_of_vertices)
+				valid_faces = false;
+		}
+	});
+
+	if(!valid_faces)
+		return std::nullopt;
+
+	if(!texture_name.empty())
+		mesh.texture_path = path_in_directory_of(filename, texture_name);
+
+	return mesh;
+}
+
+std::optional<Mesh_data> read_obj(const std::string& filename)
+{
+	std::ifstream stream(filename);
+
+	if(!stream)
+	{
+		std::cerr << "[WARNING] read_obj : cannot open " << filename << '\n';
+		return std::nullopt;
+	}
+
+	// Attributs tels que déclarés dans le fichier
+	std::vector<Mesh_data::vec_3f> file_positions;
+	std::vector<Mesh_data::vec_4f> file_colors;
+	std::vector<Mesh_data::vec_3f> file_normals;
+	std::vector<Mesh_data::vec_2f> file_texcoords;
+
+	bool has_colors = false;
+
+	// Sommets créés par les coins des faces
+	std::vector<unsigned int> first_vertex; // premier sommet créé pour chaque position
+	std::vector<Obj_vertex> vertices;
+	std::vector<unsigned int> vertex_positions;
+	std::vector<Mesh_data::vec_3u> faces;
+
+	bool has_face_normals	= false;
+	bool has_face_texcoords = false;
+
+	std::string texture_name;
+	std::string line;
+	std::vector<unsigned int> polygon;
+
+	size_t line_number = 0;
+
+	while(std::getline(stream, line))
+	{
+		++line_number;
+
+		const char* cursor = line.c_str();
+
+		while(*cursor == ' ' || *cursor == '\t')
+			++cursor;
+
+		char* end = nullptr;
+
+		if(cursor[0] == 'v' && (cursor[1] == ' ' || cursor[1] == '\t'))
+		{
+			float values[7] = {0, 0, 0, 1, 1, 1, 1};
+			int count		= 0;
+
+			for(cursor += 1; count < 6; ++count, cursor = end)
+			{
+				values[count] = std::strtof(cursor, &end);
+
+				if(end == cursor)
+					break;
+			}
+
+			file_positions.push_back({values[0], values[1], values[2]});
+
+			// Couleur optionnelle après la position (extension utilisée par meshlab)
+			if(count == 6)
+			{
+				has_colors = true;
+				file_colors.resize(file_positions.size(), {1, 1, 1, 1});
+				file_colors.back() = {values[3], values[4], values[5], 1};
+			}
+		}
+		else if(cursor[0] == 'v' && cursor[1] == 'n')
+		{
+			float x = std::strtof(cursor + 2, &end);
+			float y = std::strtof(end, &end);
+			float z = std::strtof(end, &end);
+
+			file_normals.push_back({x, y, z});
+		}
+		else if(cursor[0] == 'v' && cursor[1] == 't')
+		{
+			float s = std::strtof(cursor + 2, &end);
+			float t = std::strtof(end, &end);
+
+			file_texcoords.push_back({s, t});
+		}
+		else if(cursor[0] == 'f' && (cursor[1] == ' ' || cursor[1] == '\t'))
+		{
+			polygon.clear();
+			cursor += 1;
+
+			while(true)
+			{
+				long position = std::strtol(cursor, &end, 10);
+
+				if(end == cursor)
+					break;
+
+				// -1 : pas de coordonnée de texture / normale pour ce coin
+				long texcoord = -1;
+				long normal	  = -1;
+
+				// Un index donné doit désigner un attribut existant, une fois résolu
+				bool valid = true;
+
+				auto read_index = [&](size_t size) {
+					long index = std::strtol(cursor, &end, 10);
+
+					if(end == cursor)
+					{
+						valid = false;
+						return -1L;
+					}
+
+					cursor = end;
+					index  = obj_index(index, size);
+
+					if(index < 0 || index >= static_cast<long>(size))
+						valid = false;
+
+					return index;
+				};
+
+				cursor = end;
+
+				if(*cursor == '/')
+				{
+					++cursor;
+
+					if(*cursor != '/')
+						texcoord = read_index(file_texcoords.size());
+
+					if(*cursor == '/')
+					{
+						++cursor;
+						normal = read_index(file_normals.size());
+					}
+				}
+
+				position = obj_index(position, file_positions.size());
+
+				if(!valid || position < 0 || position >= static_cast<long>(file_positions.size()))
+				{
+					std::cerr << "[WARNING] read_obj : invalid index at line " << line_number
+							  << " of " << filename << '\n';
+					return std::nullopt;
+				}
+
+				has_face_texcoords |= texcoord >= 0;
+				has_face_normals |= normal >= 0;
+
+				// Recherche du triplet parmi les sommets déjà créés pour cette position
+				if(first_vertex.size() < file_positions.size())
+					first_vertex.resize(file_positions.size(), obj_no_vertex);
+
+				unsigned int* link = &first_vertex[static_cast<size_t>(position)];
+
+				while(*link != obj_no_vertex &&
+					  (vertices[*link].texcoord != texcoord || vertices[*link].normal != normal))
+					link = &vertices[*link].next;
+
+				if(*link == obj_no_vertex)
+				{
+					*link = static_cast<unsigned int>(vertices.size());
+					vertices.push_back(
+						{static_cast<int>(texcoord), static_cast<int>(normal), obj_no_vertex});
+					vertex_positions.push_back(static_cast<unsigned int>(position));
+				}
+
+				polygon.push_back(*link);
+			}
+
+			for(size_t j = 2; j < polygon.size(); ++j)
+				faces.push_back({polygon[0], polygon[j - 1], polygon[j]});
+		}
+		else if(std::strncmp(cursor, "mtllib", 6) == 0 && texture_name.empty())
+		{
+			std::istringstream tokens(cursor + 6);
+			std::string mtl_name;
+			tokens >> mtl_name;
+			strip_carriage_return(mtl_name);
+
+			texture_name = read_mtl_texture_name(path_in_directory_of(filename, mtl_name));
+		}
+	}
+
+	if(vertices.empty())
+	{
+		std::cerr << "[WARNING] read_obj : " << filename << " contains no faces\n";
+		return std::nullopt;
+	}
+
+	Mesh_data mesh_data;
+
+	auto& positions = mesh_data.positions.emplace(vertices.size());
+
+	for(size_t i = 0; i < vertices.size(); ++i)
+		positions[i] = file_positions[vertex_positions[i]];
+
+	if(has_colors)
+	{
+		file_colors.resize(file_positions.size(), {1, 1, 1, 1});
+
+		auto& colors = mesh_data.colors.emplace(vertices.size());
+
+		for(size_t i = 0; i < vertices.size(); ++i)
+			colors[i] = file_colors[vertex_positions[i]];
+	}
+
+	if(has_face_texcoords)
+	{
+		auto& texcoords = mesh_data.texcoords.emplace(vertices.size(), Mesh_data::vec_2f{0, 0});
+
+		for(size_t i = 0; i < vertices.size(); ++i)
+		{
+			if(vertices[i].texcoord >= 0)
+				texcoords[i] = file_texcoords[static_cast<size_t>(vertices[i].texcoord)];
+		}
+	}
+
+	mesh_data.triangulated_faces = std::move(faces);
+
+	if(has_face_normals)
+	{
+		auto& normals = mesh_data.normals.emplace(vertices.size(), Mesh_data::vec_3f{0, 0, 0});
+
+		for(size_t i = 0; i < vertices.size(); ++i)
+		{
+			if(vertices[i].normal >= 0)
+				normals[i] = file_normals[static_cast<size_t>(vertices[i].normal)];
+		}
+	}
+	else
+	{
+		compute_vertex_normals(mesh_data);
+	}
+
+	if(!texture_name.empty())
+		mesh_data.texture_path = path_in_directory_of(filename, texture_name);
+
+	return mesh_data;
+}
+
+void compute_vertex_normals(Mesh_data& mesh_data)
+{
+	if(!mesh_data.positions.has_value())
+		return;
+
+	const auto& positions = *mesh_data.positions;
+	auto& normals = mesh_data.normals.emplace(positions.size(), Mesh_data::vec_3f{0, 0, 0});
+
+	if(mesh_data.triangulated_faces.has_value())
+	{
+		for(const auto& face : *mesh_data.triangulated_faces)
+		{
+			const auto& a = positions[face[0]];
+			const auto& b = positions[face[1]];
+			const auto& c = positions[face[2]];
+
+			float u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+			float v[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+
+			// Le produit vectoriel a pour norme deux fois l'aire de la face
+			float n[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2],
+						  u[0] * v[1] - u[1] * v[0]};
+
+			for(auto vertex : face)
+			{
+				normals[vertex][0] += n[0];
+				normals[vertex][1] += n[1];
+				normals[vertex][2] += n[2];
+			}
+		}
+	}
+
+	for(auto& normal : normals)
+	{
+		float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] +
+								 normal[2] * normal[2]);
+
+		if(length > 0)
+		{
+			normal[0] /= length;
+			normal[1] /= length;
+			normal[2] /= length;
+		}
+	}
+}
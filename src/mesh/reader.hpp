@@ -0,0 +1,49 @@
+#ifndef MESH_READER_HPP
+#define MESH_READER_HPP
+
+// PROJECT
+
+#include "data.hpp"
+#include "mapping.hpp"
+
+// STD
+
+#include <optional>
+#include <string>
+
+// Lecteurs natifs des formats PLY (ascii, binaire little/big endian) et OBJ. Les fichiers sont lus
+// par blocs et décodés directement dans un Mesh_data dont les tableaux sont préalloués quand le
+// format donne le nombre d'éléments (en-tête PLY), sans passer par une scène assimp.
+//
+// Les faces polygonales sont triangulées en éventail. Si le fichier ne contient pas de normales,
+// elles sont calculées par sommet (cf. compute_vertex_normals).
+//
+// Les groupes et objets d'un OBJ ('g', 'o') ne sont pas séparés : toutes les faces du fichier
+// forment un seul maillage, là où l'import assimp ne garde que le premier maillage de la scène
+// (cf. find_mesh_index). Les fichiers de data/ ne déclarent pas de groupes.
+//
+// Ces fonctions renvoient std::nullopt si le fichier n'est pas supporté (extension inconnue,
+// propriété inattendue, ...) ou invalide (nombres d'éléments ou tailles de listes qui dépassent la
+// taille du fichier, index de sommet, de coordonnée de texture ou de normale négatif ou hors
+// limites) : l'appelant peut alors se rabattre sur assimp (cf. import.hpp).
+
+// Renvoie vrai si l'extension du fichier est lue par read_mesh_data (.ply et .obj)
+bool has_native_reader(const std::string& filename);
+
+std::optional<Mesh_data> read_mesh_data(const std::string& filename);
+
+std::optional<Mesh_data> read_ply(const std::string& filename);
+std::optional<Mesh_data> read_obj(const std::string& filename);
+
+// Variante sans copie de read_ply pour les PLY binaires little endian (sur une machine little
+// endian) dont les sommets n'ont que des propriétés scalaires (dont des normales) et dont toutes les
+// faces sont des triangles : le fichier est projeté en mémoire et les attributs pointent dans le
+// bloc des sommets. Renvoie std::nullopt pour tout autre fichier, ou si les tailles de l'en-tête ne
+// correspondent pas à celle du fichier (l'appelant utilise alors read_mesh_data, qui calcule les
+// normales absentes, ou assimp).
+std::optional<Mapped_mesh> map_ply(const std::string& filename);
+
+// Calcule les normales des sommets comme la moyenne des normales des faces pondérées par leurs aires
+void compute_vertex_normals(Mesh_data& mesh_data);
+
+#endif // MESH_READER_HPP
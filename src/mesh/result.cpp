@@ -0,0 +1,21 @@
+#include "result.hpp"
+
+Result<void>::Result(Error error) : m_error(std::move(error))
+{
+}
+
+bool Result<void>::has_value() const
+{
+	return !m_error;
+}
+
+Result<void>::operator bool() const
+{
+	return has_value();
+}
+
+const std::string& Result<void>::error() const
+{
+	assert(m_error);
+	return m_error->message;
+}
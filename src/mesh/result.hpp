@@ -0,0 +1,68 @@
+#ifndef MESH_RESULT_HPP
+#define MESH_RESULT_HPP
+
+// STD
+
+#include <optional>
+#include <string>
+#include <variant>
+
+// Erreur renvoyée par les fonctions try_* (le message peut être affiché tel quel)
+struct Error
+{
+	std::string message;
+};
+
+// Valeur de type T ou erreur, à la manière de std::expected (C++23). Les fonctions try_* renvoient
+// un Result au lieu d'appeler exit : un même processus peut enchaîner plusieurs traitements (cf.
+// match --batch) et continuer après l'échec de l'un d'eux.
+template <class T>
+class Result
+{
+  public:
+	Result(const T& value);
+	Result(T&& value);
+	Result(Error error);
+
+	bool has_value() const;
+	explicit operator bool() const;
+
+	// Precondition : has_value()
+	T& value();
+	const T& value() const;
+
+	T& operator*();
+	const T& operator*() const;
+	T* operator->();
+	const T* operator->() const;
+
+	// Precondition : !has_value()
+	const std::string& error() const;
+
+  protected:
+	std::variant<T, Error> m_data;
+};
+
+// Opération qui ne renvoie rien en cas de succès
+template <>
+class Result<void>
+{
+  public:
+	Result() = default;
+	Result(Error error);
+
+	bool has_value() const;
+	explicit operator bool() const;
+
+	// Precondition : !has_value()
+	const std::string& error() const;
+
+  protected:
+	std::optional<Error> m_error;
+};
+
+using Status = Result<void>;
+
+#include "result.inl"
+
+#endif // MESH_RESULT_HPP
@@ -0,0 +1,83 @@
+#ifndef MESH_RESULT_INL
+#define MESH_RESULT_INL
+
+#include "result.hpp"
+
+// STD
+
+#include <cassert>
+#include <utility>
+
+template <class T>
+Result<T>::Result(const T& value) : m_data(std::in_place_index<0>, value)
+{
+}
+
+template <class T>
+Result<T>::Result(T&& value) : m_data(std::in_place_index<0>, std::move(value))
+{
+}
+
+template <class T>
+Result<T>::Result(Error error) : m_data(std::in_place_index<1>, std::move(error))
+{
+}
+
+template <class T>
+bool Result<T>::has_value() const
+{
+	return m_data.index() == 0;
+}
+
+template <class T>
+Result<T>::operator bool() const
+{
+	return has_value();
+}
+
+template <class T>
+T& Result<T>::value()
+{
+	assert(has_value());
+	return *std::get_if<0>(&m_data);
+}
+
+template <class T>
+const T& Result<T>::value() const
+{
+	assert(has_value());
+	return *std::get_if<0>(&m_data);
+}
+
+template <class T>
+T& Result<T>::operator*()
+{
+	return value();
+}
+
+template <class T>
+const T& Result<T>::operator*() const
+{
+	return value();
+}
+
+template <class T>
+T* Result<T>::operator->()
+{
+	return &value();
+}
+
+template <class T>
+const T* Result<T>::operator->() const
+{
+	return &value();
+}
+
+template <class T>
+const std::string& Result<T>::error() const
+{
+	assert(!has_value());
+	return std::get_if<1>(&m_data)->message;
+}
+
+#endif // MESH_RESULT_INL
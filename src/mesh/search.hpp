@@ -0,0 +1,109 @@
+#ifndef MESH_SEARCH_HPP
+#define MESH_SEARCH_HPP
+
+#include "../instance/Surface_mesh_kd_tree.hpp"
+#include "result.hpp"
+
+// STD
+
+#include <map>
+#include <memory>
+#include <vector>
+
+// Résultat d'une requête de plus proche voisin dans un SM_kd_tree
+struct Nearest_vertex
+{
+	Surface_mesh::Vertex_index vertex;
+	double squared_distance;
+};
+
+// Recherche du plus proche voisin réutilisable : la distance (adaptée à la carte des points de
+// l'arbre) est préparée une fois, puis chaque requête passe par SM_kd_tree_orthogonal_search
+// (K = 1). Un objet par thread suffit pour toute une série de requêtes.
+// Un arbre vide donne un sommet nul à une distance infinie.
+// Precondition : 'tree' doit être construit (cf. prepare_concurrent_queries) s'il est partagé
+// entre plusieurs threads.
+class Nearest_vertex_search
+{
+  public:
+	explicit Nearest_vertex_search(const SM_kd_tree& tree);
+
+	Nearest_vertex operator()(const Kernel::Point_3& point) const;
+
+  private:
+	const SM_kd_tree& m_tree;
+	SM_kd_tree_orthogonal_search::Distance m_distance;
+};
+
+// Le kd-tree CGAL se construit paresseusement à la première requête : cette fonction force sa
+// construction pour que des threads puissent ensuite l'interroger en lecture seule.
+void prepare_concurrent_queries(const SM_kd_tree& tree);
+
+// Recherche le sommet de 'tree' le plus proche de chaque sommet 'vertices' de 'mesh'.
+// Les résultats sont rangés dans 'result' dans l'ordre de parcours de 'vertices' (la mémoire de
+// 'result' est réutilisée d'un appel à l'autre). Les requêtes sont réparties sur plusieurs threads
+// si 'parallel' est vrai, chaque thread réutilisant sa propre Nearest_vertex_search.
+// Si 'tree' est vide, chaque résultat est un sommet nul à une distance infinie.
+template <class VertexRange>
+void nearest_vertices(const Surface_mesh& mesh, const VertexRange& vertices,
+					  const SM_kd_tree& tree, std::vector<Nearest_vertex>& result,
+					  bool parallel = true);
+
+template <class VertexRange>
+std::vector<Nearest_vertex> nearest_vertices(const Surface_mesh& mesh,
+											 const VertexRange& vertices,
+											 const SM_kd_tree& tree, bool parallel = true);
+
+// Comme nearest_vertices mais renvoie une erreur au lieu de distances infinies quand 'tree' est
+// vide alors que 'vertices' ne l'est pas
+template <class VertexRange>
+Result<std::vector<Nearest_vertex>> try_nearest_vertices(const Surface_mesh& mesh,
+														 const VertexRange& vertices,
+														 const SM_kd_tree& tree,
+														 bool parallel = true);
+
+// Recherche le sommet de 'tree' le plus proche d'un point (une recherche est créée pour l'occasion :
+// préférer Nearest_vertex_search pour une série de requêtes). Renvoie un sommet nul à une distance
+// infinie si 'tree' est vide.
+Nearest_vertex nearest_vertex(const SM_kd_tree& tree, const Kernel::Point_3& point);
+
+// Indique si au moins un sommet de 'tree' se trouve à une distance inférieure ou égale à 'radius'
+// de 'point'. La recherche s'arrête au premier sommet trouvé et élague les cellules du kd-tree
+// hors de la sphère : elle est bien plus rapide qu'une recherche du plus proche voisin quand le
+// point est loin de l'arbre.
+bool has_vertex_within(const SM_kd_tree& tree, const Kernel::Point_3& point, double radius);
+
+// Cache de kd-trees : un arbre par maillage (indexant tous ses sommets), construit à la première
+// demande puis réutilisé par les étapes de projection / annotation qui portent sur le même
+// maillage. Les arbres sont identifiés par l'adresse du maillage et par une version de sa géométrie
+// qu'il faut incrémenter avec 'invalidate' dès que ses points changent.
+// Precondition : un maillage doit survivre à son arbre et ne pas être déplacé en mémoire.
+class SM_kd_tree_cache
+{
+  public:
+	// Renvoie l'arbre indexant les sommets de 'mesh' (construit s'il n'existe pas encore)
+	const SM_kd_tree& tree(const Surface_mesh& mesh);
+
+	// Indique que la géométrie de 'mesh' a changé : son arbre sera reconstruit à la prochaine demande
+	void invalidate(const Surface_mesh& mesh);
+
+	size_t number_of_builds() const;
+	size_t number_of_reuses() const;
+
+  private:
+	struct Entry
+	{
+		size_t geometry_version = 0;
+		size_t tree_version		= 0;
+		std::unique_ptr<SM_kd_tree> tree;
+	};
+
+	std::map<const Surface_mesh*, Entry> m_entries;
+
+	size_t m_number_of_builds = 0;
+	size_t m_number_of_reuses = 0;
+};
+
+#include "search.inl"
+
+#endif // MESH_SEARCH_HPP
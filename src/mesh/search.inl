@@ -0,0 +1,149 @@
+#ifndef MESH_SEARCH_INL
+#define MESH_SEARCH_INL
+
+#include "search.hpp"
+
+#include "parallel.hpp"
+
+// CGAL
+
+#include <CGAL/Fuzzy_sphere.h>
+
+// STD
+
+#include <limits>
+
+void prepare_concurrent_queries(const SM_kd_tree& tree)
+{
+	// Un arbre vide n'a rien à construire (et CGAL ne construit pas d'arbre sans points)
+	if(tree.size() > 0 && !tree.is_built())
+		const_cast<SM_kd_tree&>(tree).build();
+}
+
+Nearest_vertex_search::Nearest_vertex_search(const SM_kd_tree& tree)
+	: m_tree(tree), m_distance(tree.traits().point_property_map())
+{
+}
+
+Nearest_vertex Nearest_vertex_search::operator()(const Kernel::Point_3& point) const
+{
+	// Vérifié à chaque requête (et pas seulement en debug) : la recherche de CGAL ne doit pas
+	// parcourir un arbre vide
+	if(m_tree.size() == 0)
+		return {Surface_mesh::Vertex_index(), std::numeric_limits<double>::infinity()};
+
+	SM_kd_tree_orthogonal_search search(m_tree, point, 1, 0, true, m_distance);
+
+	if(search.begin() == search.end())
+		return {Surface_mesh::Vertex_index(), std::numeric_limits<double>::infinity()};
+
+	return {search.begin()->first, search.begin()->second};
+}
+
+Nearest_vertex nearest_vertex(const SM_kd_tree& tree, const Kernel::Point_3& point)
+{
+	prepare_concurrent_queries(tree);
+
+	return Nearest_vertex_search(tree)(point);
+}
+
+bool has_vertex_within(const SM_kd_tree& tree, const Kernel::Point_3& point, double radius)
+{
+	CGAL::Fuzzy_sphere<SM_kd_tree_traits_adapter> sphere(point, radius, 0, tree.traits());
+
+	return static_cast<bool>(tree.search_any_point(sphere));
+}
+
+template <class VertexRange>
+void nearest_vertices(const Surface_mesh& mesh, const VertexRange& vertices,
+					  const SM_kd_tree& tree, std::vector<Nearest_vertex>& result,
+					  bool parallel)
+{
+	// Les index sont recopiés pour pouvoir découper les requêtes en blocs
+	std::vector<Surface_mesh::Vertex_index> queries(vertices.begin(), vertices.end());
+
+	result.resize(queries.size());
+
+	if(queries.empty())
+		return;
+
+	prepare_concurrent_queries(tree);
+
+	auto query_chunk = [&](std::size_t begin, std::size_t end) {
+		Nearest_vertex_search search(tree);
+
+		for(std::size_t i = begin; i < end; ++i)
+			result[i] = search(mesh.point(queries[i]));
+	};
+
+	if(parallel)
+		parallel_for_chunks(queries.size(), query_chunk);
+	else
+		query_chunk(0, queries.size());
+}
+
+template <class VertexRange>
+std::vector<Nearest_vertex> nearest_vertices(const Surface_mesh& mesh,
+											 const VertexRange& vertices,
+											 const SM_kd_tree& tree, bool parallel)
+{
+	std::vector<Nearest_vertex> result;
+	nearest_vertices(mesh, vertices, tree, result, parallel);
+	return result;
+}
+
+template <class VertexRange>
+Result<std::vector<Nearest_vertex>> try_nearest_vertices(const Surface_mesh& mesh,
+														 const VertexRange& vertices,
+														 const SM_kd_tree& tree, bool parallel)
+{
+	if(tree.size() == 0 && vertices.begin() != vertices.end())
+		return Error{"nearest vertex query on an empty kd-tree"};
+
+	return nearest_vertices(mesh, vertices, tree, parallel);
+}
+
+const SM_kd_tree& SM_kd_tree_cache::tree(const Surface_mesh& mesh)
+{
+	Entry& entry = m_entries[&mesh];
+
+	if(entry.tree && entry.tree_version == entry.geometry_version)
+	{
+		++m_number_of_reuses;
+		return *entry.tree;
+	}
+
+	entry.tree.reset(new SM_kd_tree(mesh.vertices().begin(), mesh.vertices().end(),
+									SM_kd_tree_splitter(),
+									SM_kd_tree_traits_adapter(mesh.points())));
+	if(entry.tree->size() > 0)
+		entry.tree->build();
+
+	entry.tree_version = entry.geometry_version;
+
+	++m_number_of_builds;
+	return *entry.tree;
+}
+
+void SM_kd_tree_cache::invalidate(const Surface_mesh& mesh)
+{
+	auto entry = m_entries.find(&mesh);
+
+	if(entry != m_entries.end())
+	{
+		++entry->second.geometry_version;
+		entry->second.tree.reset();
+	}
+}
+
+size_t SM_kd_tree_cache::number_of_builds() const
+{
+	return m_number_of_builds;
+}
+
+size_t SM_kd_tree_cache::number_of_reuses() const
+{
+	return m_number_of_reuses;
+}
+
+#endif // MESH_SEARCH_INL
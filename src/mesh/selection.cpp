@@ -0,0 +1,201 @@
+#include "selection.hpp"
+
+// STD
+
+#include <cassert>
+
+namespace
+{
+size_t popcount(Vertex_selection::Word word)
+{
+#if defined(__GNUC__)
+	return static_cast<size_t>(__builtin_popcountll(word));
+#else
+	size_t count = 0;
+
+	for(; word != 0; word &= word - 1)
+		++count;
+
+	return count;
+#endif
+}
+} // namespace
+
+Vertex_selection::Iterator::Iterator(const Word* words, size_t nb_words, size_t word)
+	: m_words(words), m_nb_words(nb_words), m_word(word)
+{
+	if(m_word < m_nb_words)
+	{
+		m_bits = m_words[m_word];
+
+		if(m_bits == 0)
+			skip_empty_words();
+	}
+}
+
+Vertex_selection::Iterator Vertex_selection::Iterator::operator++(int)
+{
+	Iterator previous = *this;
+	++*this;
+	return previous;
+}
+
+bool Vertex_selection::Iterator::operator==(const Iterator& other) const
+{
+	return m_word == other.m_word && m_bits == other.m_bits;
+}
+
+bool Vertex_selection::Iterator::operator!=(const Iterator& other) const
+{
+	return !(*this == other);
+}
+
+void Vertex_selection::Iterator::skip_empty_words()
+{
+	while(m_bits == 0 && m_word < m_nb_words)
+	{
+		++m_word;
+
+		if(m_word < m_nb_words)
+			m_bits = m_words[m_word];
+	}
+}
+
+Vertex_selection::Vertex_selection(size_t size, bool value)
+	: m_size(size), m_words((size + word_size - 1) / word_size, value ? ~Word(0) : Word(0))
+{
+	clear_padding();
+}
+
+Vertex_selection::Vertex_selection(const Surface_mesh& mesh)
+	: Vertex_selection(mesh.num_vertices())
+{
+}
+
+size_t Vertex_selection::size() const
+{
+	return m_size;
+}
+
+size_t Vertex_selection::count() const
+{
+	size_t count = 0;
+
+	for(Word word : m_words)
+		count += popcount(word);
+
+	return count;
+}
+
+bool Vertex_selection::none() const
+{
+	for(Word word : m_words)
+	{
+		if(word != 0)
+			return false;
+	}
+
+	return true;
+}
+
+void Vertex_selection::set(Surface_mesh::Vertex_index v, bool value)
+{
+	size_t i  = static_cast<size_t>(v);
+	Word mask = Word(1) << (i % word_size);
+
+	if(value)
+		m_words[i / word_size] |= mask;
+	else
+		m_words[i / word_size] &= ~mask;
+}
+
+Vertex_selection::Iterator Vertex_selection::begin() const
+{
+	return Iterator(m_words.data(), m_words.size(), 0);
+}
+
+Vertex_selection::Iterator Vertex_selection::end() const
+{
+	return Iterator(m_words.data(), m_words.size(), m_words.size());
+}
+
+Vertex_selection& Vertex_selection::operator&=(const Vertex_selection& other)
+{
+	assert(m_size == other.m_size);
+
+	for(size_t w = 0; w < m_words.size(); ++w)
+		m_words[w] &= other.m_words[w];
+
+	return *this;
+}
+
+Vertex_selection& Vertex_selection::operator|=(const Vertex_selection& other)
+{
+	assert(m_size == other.m_size);
+
+	for(size_t w = 0; w < m_words.size(); ++w)
+		m_words[w] |= other.m_words[w];
+
+	return *this;
+}
+
+Vertex_selection& Vertex_selection::operator-=(const Vertex_selection& other)
+{
+	assert(m_size == other.m_size);
+
+	for(size_t w = 0; w < m_words.size(); ++w)
+		m_words[w] &= ~other.m_words[w];
+
+	return *this;
+}
+
+Vertex_selection Vertex_selection::operator~() const
+{
+	Vertex_selection result = *this;
+
+	for(Word& word : result.m_words)
+		word = ~word;
+
+	result.clear_padding();
+
+	return result;
+}
+
+std::vector<Vertex_selection::Word>& Vertex_selection::words()
+{
+	return m_words;
+}
+
+const std::vector<Vertex_selection::Word>& Vertex_selection::words() const
+{
+	return m_words;
+}
+
+void Vertex_selection::clear_padding()
+{
+	if(m_size % word_size != 0)
+		m_words.back() &= (Word(1) << (m_size % word_size)) - 1;
+}
+
+Vertex_selection operator&(Vertex_selection a, const Vertex_selection& b)
+{
+	a &= b;
+	return a;
+}
+
+Vertex_selection operator|(Vertex_selection a, const Vertex_selection& b)
+{
+	a |= b;
+	return a;
+}
+
+Vertex_selection operator-(Vertex_selection a, const Vertex_selection& b)
+{
+	a -= b;
+	return a;
+}
+
+Vertex_selection all_vertices(const Surface_mesh& mesh)
+{
+	return select_vertices(mesh, [](Surface_mesh::Vertex_index) { return true; });
+}
@@ -0,0 +1,158 @@
+#ifndef MESH_SELECTION_HPP
+#define MESH_SELECTION_HPP
+
+// PROJECT
+
+#include "../instance/Surface_mesh.hpp"
+
+// STD
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+// Ensemble de sommets d'une Surface_mesh rangé dans un tableau de bits indexé par Vertex_index
+// (un bit par sommet, sommets effacés compris). Contrairement à une liste d'index, il n'alloue
+// que mesh.num_vertices() / 8 octets, teste l'appartenance d'un sommet en temps constant et se
+// combine avec d'autres sélections du même maillage mot par mot (&, |, -, ~).
+//
+// Le parcours (begin/end) renvoie les sommets sélectionnés dans l'ordre croissant des index, qui
+// est l'ordre de mesh.vertices() : une sélection peut donc remplacer une liste de sommets partout
+// où un VertexRange est attendu (set_mesh_color, projection, constructeur de SM_kd_tree, ...).
+class Vertex_selection
+{
+  public:
+	using Word = std::uint64_t;
+
+	static constexpr size_t word_size = 64;
+
+	// Itérateur sur les bits à 1 (le mot courant est consommé bit par bit)
+	class Iterator
+	{
+	  public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type		= Surface_mesh::Vertex_index;
+		using difference_type	= std::ptrdiff_t;
+		using pointer			= const value_type*;
+		using reference			= value_type;
+
+		Iterator() = default;
+		Iterator(const Word* words, size_t nb_words, size_t word);
+
+		value_type operator*() const;
+
+		Iterator& operator++();
+		Iterator operator++(int);
+
+		bool operator==(const Iterator& other) const;
+		bool operator!=(const Iterator& other) const;
+
+	  protected:
+		// Passe au prochain mot non nul (ou à la fin)
+		void skip_empty_words();
+
+		const Word* m_words = nullptr;
+		size_t m_nb_words	= 0;
+		size_t m_word		= 0;
+		Word m_bits			= 0;
+	};
+
+	Vertex_selection() = default;
+
+	// Sélection vide (ou pleine si 'value') de 'size' sommets
+	explicit Vertex_selection(size_t size, bool value = false);
+
+	// Sélection vide aux dimensions de 'mesh'
+	explicit Vertex_selection(const Surface_mesh& mesh);
+
+	// Nombre d'index couverts (mesh.num_vertices())
+	size_t size() const;
+
+	// Nombre de sommets sélectionnés
+	size_t count() const;
+
+	bool none() const;
+
+	bool test(Surface_mesh::Vertex_index v) const;
+	void set(Surface_mesh::Vertex_index v, bool value = true);
+
+	Iterator begin() const;
+	Iterator end() const;
+
+	// Précondition : les deux sélections ont la même taille
+	Vertex_selection& operator&=(const Vertex_selection& other);
+	Vertex_selection& operator|=(const Vertex_selection& other);
+	Vertex_selection& operator-=(const Vertex_selection& other);
+
+	// Complément sur tous les index : il contient les sommets effacés du maillage s'il en a
+	// (utilisez all_vertices(mesh) - selection dans ce cas)
+	Vertex_selection operator~() const;
+
+	// Mots du tableau de bits, le bit i % 64 du mot i / 64 correspond au sommet i
+	std::vector<Word>& words();
+	const std::vector<Word>& words() const;
+
+  protected:
+	// Met à 0 les bits du dernier mot au-delà de size()
+	void clear_padding();
+
+	size_t m_size = 0;
+	std::vector<Word> m_words;
+};
+
+Vertex_selection operator&(Vertex_selection a, const Vertex_selection& b);
+Vertex_selection operator|(Vertex_selection a, const Vertex_selection& b);
+Vertex_selection operator-(Vertex_selection a, const Vertex_selection& b);
+
+// Tous les sommets (non effacés) de 'mesh'
+Vertex_selection all_vertices(const Surface_mesh& mesh);
+
+// Sélection des sommets non effacés v de 'mesh' pour lesquels 'predicate(v)' est vrai. Les mots
+// sont répartis entre les threads : chaque mot est écrit par un seul thread.
+template <class Predicate>
+Vertex_selection select_vertices(const Surface_mesh& mesh, Predicate&& predicate);
+
+// Sélection des sommets d'une liste
+template <class VertexRange>
+Vertex_selection make_vertex_selection(const Surface_mesh& mesh, const VertexRange& vertices);
+
+// Appelé pour chaque sommet parcouru : défini dans l'en-tête pour pouvoir être inliné
+inline bool Vertex_selection::test(Surface_mesh::Vertex_index v) const
+{
+	size_t i = static_cast<size_t>(v);
+	return (m_words[i / word_size] >> (i % word_size)) & 1;
+}
+
+inline Vertex_selection::Iterator::value_type Vertex_selection::Iterator::operator*() const
+{
+	Word bits  = m_bits;
+	size_t bit = 0;
+
+#if defined(__GNUC__)
+	bit = static_cast<size_t>(__builtin_ctzll(bits));
+#else
+	while(!(bits & 1))
+	{
+		bits >>= 1;
+		++bit;
+	}
+#endif
+
+	return value_type(static_cast<Surface_mesh::size_type>(m_word * word_size + bit));
+}
+
+inline Vertex_selection::Iterator& Vertex_selection::Iterator::operator++()
+{
+	// Efface le bit de poids faible
+	m_bits &= m_bits - 1;
+
+	if(m_bits == 0)
+		skip_empty_words();
+
+	return *this;
+}
+
+#include "selection.inl"
+
+#endif // MESH_SELECTION_HPP
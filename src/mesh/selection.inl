@@ -0,0 +1,53 @@
+#ifndef MESH_SELECTION_INL
+#define MESH_SELECTION_INL
+
+#include "selection.hpp"
+
+#include "parallel.hpp"
+
+// STD
+
+#include <algorithm>
+
+template <class Predicate>
+Vertex_selection select_vertices(const Surface_mesh& mesh, Predicate&& predicate)
+{
+	Vertex_selection selection(mesh);
+
+	auto& words		 = selection.words();
+	size_t nb_bits	 = selection.size();
+	size_t word_size = Vertex_selection::word_size;
+
+	parallel_for(
+		words.size(),
+		[&](size_t w) {
+			Vertex_selection::Word word = 0;
+			size_t end					= std::min(nb_bits, (w + 1) * word_size);
+
+			for(size_t i = w * word_size; i < end; ++i)
+			{
+				Surface_mesh::Vertex_index v(static_cast<Surface_mesh::size_type>(i));
+
+				if(!mesh.is_removed(v) && predicate(v))
+					word |= Vertex_selection::Word(1) << (i % word_size);
+			}
+
+			words[w] = word;
+		},
+		16);
+
+	return selection;
+}
+
+template <class VertexRange>
+Vertex_selection make_vertex_selection(const Surface_mesh& mesh, const VertexRange& vertices)
+{
+	Vertex_selection selection(mesh);
+
+	for(auto v : vertices)
+		selection.set(v);
+
+	return selection;
+}
+
+#endif // MESH_SELECTION_INL
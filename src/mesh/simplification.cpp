@@ -0,0 +1,101 @@
+#include "simplification.hpp"
+
+// PROJECT
+
+#include "conversion.hpp"
+
+// CGAL
+
+#include <CGAL/Surface_mesh_simplification/Policies/Edge_collapse/Count_ratio_stop_predicate.h>
+#include <CGAL/Surface_mesh_simplification/edge_collapse.h>
+#include <CGAL/boost/graph/helpers.h>
+#include <CGAL/version_macros.h>
+
+#if CGAL_VERSION_NR >= CGAL_VERSION_NUMBER(5, 5, 0)
+#include <CGAL/Surface_mesh_simplification/Policies/Edge_collapse/GarlandHeckbert_plane_policies.h>
+#elif CGAL_VERSION_NR >= CGAL_VERSION_NUMBER(5, 3, 0)
+#include <CGAL/Surface_mesh_simplification/Policies/Edge_collapse/GarlandHeckbert_policies.h>
+#endif
+
+// STD
+
+#include <iostream>
+
+namespace SMS = CGAL::Surface_mesh_simplification;
+
+namespace
+{
+
+// Un niveau qui garde plus de cette proportion des faces du précédent n'est pas conservé
+constexpr double minimum_reduction = 0.8;
+
+// Les maillages plus petits ne sont pas simplifiés
+constexpr size_t minimum_number_of_faces = 256;
+
+} // namespace
+
+Surface_mesh simplified(const Surface_mesh& mesh, double ratio)
+{
+	Surface_mesh result = mesh;
+
+	SMS::Count_ratio_stop_predicate<Surface_mesh> stop(ratio);
+
+#if CGAL_VERSION_NR >= CGAL_VERSION_NUMBER(5, 3, 0)
+	// Coût et placement de Garland et Heckbert (quadriques des plans des faces). CGAL 5.3 et 5.4
+	// (ex: Ubuntu 22.04) n'ont que GarlandHeckbert_policies, renommée à partir de CGAL 5.5.
+#if CGAL_VERSION_NR >= CGAL_VERSION_NUMBER(5, 5, 0)
+	SMS::GarlandHeckbert_plane_policies<Surface_mesh, Kernel> policies(result);
+#else
+	SMS::GarlandHeckbert_policies<Surface_mesh, Kernel> policies(result);
+#endif
+
+	SMS::edge_collapse(result, stop,
+					   CGAL::parameters::get_cost(policies.get_cost())
+						   .get_placement(policies.get_placement()));
+#else
+	// Avant CGAL 5.3, la politique par défaut (Lindstrom-Turk) est aussi quadrique
+	SMS::edge_collapse(result, stop);
+#endif
+
+	// Les sommets, arêtes et faces contractés sont seulement marqués comme supprimés
+	result.collect_garbage();
+
+	return result;
+}
+
+std::vector<Mesh_data> make_levels_of_detail(const Surface_mesh& mesh,
+											 const std::vector<double>& ratios)
+{
+	std::vector<Mesh_data> levels;
+
+	if(!CGAL::is_triangle_mesh(mesh))
+	{
+		std::cerr << "[WARNING] make_levels_of_detail : mesh is not triangulated\n";
+		return levels;
+	}
+
+	Surface_mesh level	   = mesh;
+	double level_ratio	   = 1.0;
+	size_t number_of_faces = mesh.number_of_faces();
+
+	for(double ratio : ratios)
+	{
+		if(number_of_faces < minimum_number_of_faces)
+			break;
+
+		// Le niveau précédent a déjà été réduit de 'level_ratio'
+		level		= simplified(level, ratio / level_ratio);
+		level_ratio = ratio;
+
+		if(level.number_of_faces() > minimum_reduction * number_of_faces)
+			break;
+
+		number_of_faces = level.number_of_faces();
+		levels.push_back(to_mesh_data(level));
+
+		std::clog << "[STATUS] level of detail " << levels.size() << " : " << number_of_faces
+				  << " faces\n";
+	}
+
+	return levels;
+}
@@ -0,0 +1,27 @@
+#ifndef MESH_SIMPLIFICATION_HPP
+#define MESH_SIMPLIFICATION_HPP
+
+// PROJECT
+
+#include "../instance/Surface_mesh.hpp"
+#include "data.hpp"
+
+// STD
+
+#include <vector>
+
+// Simplifie un maillage triangulaire par contraction d'arêtes (métrique quadrique) jusqu'à ce
+// qu'il ne reste que 'ratio' de ses arêtes. Les attributs des sommets conservés (normales,
+// couleurs, coordonnées de texture) sont gardés tels quels.
+Surface_mesh simplified(const Surface_mesh& mesh, double ratio);
+
+// Construit des niveaux de détail de plus en plus grossiers : le niveau k garde environ ratios[k]
+// des faces de 'mesh' (ratios décroissants). Chaque niveau est obtenu en simplifiant le précédent.
+// La construction s'arrête dès qu'un niveau ne réduit plus assez le nombre de faces (maillage
+// fait de triangles isolés par exemple). Les niveaux n'ont pas de texture_path : ils partagent la
+// texture du maillage d'origine. Renvoie un tableau vide si 'mesh' n'est pas triangulaire.
+std::vector<Mesh_data> make_levels_of_detail(const Surface_mesh& mesh,
+											 const std::vector<double>& ratios = {0.25, 0.0625,
+																				  0.015625});
+
+#endif // MESH_SIMPLIFICATION_HPP
@@ -3,7 +3,9 @@
 
 #include "../instance/Surface_mesh.hpp"
 
+#include "division.hpp"
 #include "marking.hpp"
+#include "selection.hpp"
 
 // CGAL
 #include <CGAL/IO/Color.h>
@@ -23,17 +25,25 @@ Surface_mesh translated(const Surface_mesh& mesh, const Kernel::Vector_3& v);
 
 // FILTER
 
-// Enlève les sommets 'vertices' du maillages 'mesh'
+// Enlève les sommets 'vertices' du maillages 'mesh' (et toutes les faces qui les touchent). Le
+// résultat est construit directement avec des index compacts (cf. split_faces).
 template <class VertexRange>
 Surface_mesh filtered(const Surface_mesh& mesh, const VertexRange& vertices);
+Surface_mesh filtered(const Surface_mesh& mesh, const Vertex_selection& vertices);
 
 // // DIVIDE
 
-// Divise un maillage en deux.
+// Divise un maillage en deux en une passe : les faces sans sommet 'distant' et les faces sans
+// sommet 'close'. Les sommets 'limit' appartiennent aux deux parties (ils sont dupliqués le long
+// de la couture).
 // Precondition : le maillage mesh doit avoir ses sommets annotés 'close/distant' (cf. marking.hpp).
 // si vous voulez dupliquez les sommets limites rajoutez l'annotation 'limit' sur les sommets.
 std::pair<Surface_mesh, Surface_mesh> divide(const Surface_mesh& mesh);
 
+// Même chose avec les annotations d'un autre maillage dont les sommets ont les mêmes index que
+// ceux de 'mesh' (ex: divide(mesh, get_marking_map(projection)))
+std::pair<Surface_mesh, Surface_mesh> divide(const Surface_mesh& mesh, const SM_marking_map& marks);
+
 #include "utils.inl"
 
 #endif // MESH_UTILS_HPP
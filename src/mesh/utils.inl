@@ -67,47 +67,56 @@ Surface_mesh translated(const Surface_mesh& mesh, const Kernel::Vector_3& v)
 template <class VertexRange>
 Surface_mesh filtered(const Surface_mesh& mesh, const VertexRange& vertices)
 {
-	Surface_mesh result = mesh;
+	return filtered(mesh, make_vertex_selection(mesh, vertices));
+}
 
-	for(auto vertex_index : vertices)
+Surface_mesh filtered(const Surface_mesh& mesh, const Vertex_selection& vertices)
+{
+	// Une face est gardée si aucun de ses sommets n'est enlevé
+	std::vector<unsigned char> face_parts(mesh.num_faces(), 0);
+
+	for(auto f : mesh.faces())
 	{
-		// Le sommet à potientiellement pu être effacer par un remove_face
-		// precedant On passe au prochain sommet pour eviter les erreurs
-		if(result.is_removed(vertex_index))
-			continue;
+		bool kept = true;
+
+		for(auto v : CGAL::vertices_around_face(mesh.halfedge(f), mesh))
+			kept = kept && !vertices.test(v);
 
-		std::vector<Surface_mesh::Halfedge_index> low_dist_halfhedges;
+		face_parts[f] = kept ? 1 : 0;
+	}
 
-		auto halfedges = CGAL::halfedges_around_target(vertex_index, result);
+	return std::move(split_faces(mesh, face_parts, 1).front());
+}
 
-		// Sans cette etapes remove_face plantera pendant l'iteration (on efface
-		// des halfedge en iterant de)
-		for(auto h : halfedges)
-		{
-			// if(!result.is_border(h))
-			low_dist_halfhedges.push_back(h);
-		}
+// DIVIDE
 
-		for(auto h : low_dist_halfhedges)
+std::pair<Surface_mesh, Surface_mesh> divide(const Surface_mesh& mesh, const SM_marking_map& marks)
+{
+	// Bit 0 : partie proche (pas de sommet distant), bit 1 : partie distante (pas de sommet proche)
+	std::vector<unsigned char> face_parts(mesh.num_faces(), 0);
+
+	for(auto f : mesh.faces())
+	{
+		bool has_close	 = false;
+		bool has_distant = false;
+
+		for(auto v : CGAL::vertices_around_face(mesh.halfedge(f), mesh))
 		{
-			// Il est necessaire de re-checker à chaque fois car remove_face
-			// change l'état du maillage
-			if(!result.is_border(h))
-				CGAL::Euler::remove_face(h, result);
+			has_close	= has_close || marks[v] == Vertex_mark::Close;
+			has_distant = has_distant || marks[v] == Vertex_mark::Distant;
 		}
+
+		face_parts[f] = (has_distant ? 0 : 1) | (has_close ? 0 : 2);
 	}
 
-	return result;
-}
+	auto parts = split_faces(mesh, face_parts, 2);
 
-// DIVIDE
+	return {std::move(parts[0]), std::move(parts[1])};
+}
 
 std::pair<Surface_mesh, Surface_mesh> divide(const Surface_mesh& mesh)
 {
-	Surface_mesh M1_close	= filtered(mesh, distant_vertices(mesh));
-	Surface_mesh M1_distant = filtered(mesh, close_vertices(mesh));
-
-	return {M1_close, M1_distant};
+	return divide(mesh, get_marking_map(mesh));
 }
 
 // template <class P>
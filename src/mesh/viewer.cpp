@@ -3,24 +3,43 @@
 
 #include "viewer.hpp"
 
+#include "conversion.hpp"
+#include "simplification.hpp"
+
 // QT5
 
 #include <QMessageBox>
 
 // STD
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <exception>
 #include <limits>
 #include <memory>
+#include <utility>
+
+namespace
+{
+
+// Nombre de triangles voulu par pixel d'un maillage à l'écran (la taille à l'écran est celle de la
+// diagonale de sa boite englobante)
+constexpr double lod_triangles_per_pixel = 0.5;
+
+// Délai sans mouvement de la caméra avant de revenir aux niveaux de détail les plus fins
+constexpr int camera_motion_delay = 250; // ms
+
+} // namespace
 
 // CGAL::qglviewer::Vec bb_min(std::numeric_limits<qreal>::max(),
 
 Mesh_data::vec_3f bb_min{std::numeric_limits<float>::max(),
 				std::numeric_limits<float>::max(),
 				std::numeric_limits<float>::max()};
-Mesh_data::vec_3f bb_max{std::numeric_limits<float>::min(),
-				 std::numeric_limits<float>::min(),
-				 std::numeric_limits<float>::min()};
+Mesh_data::vec_3f bb_max{std::numeric_limits<float>::lowest(),
+				 std::numeric_limits<float>::lowest(),
+				 std::numeric_limits<float>::lowest()};
 
 /*MeshViewer::MeshViewer()
 {>
@@ -266,12 +285,28 @@ void MeshViewer::init()
 
 	this->showEntireScene();
 
+	//////////////////////// LEVELS OF DETAIL //////////////////////////
+
+	m_levels_timer.setInterval(50);
+	connect(&m_levels_timer, &QTimer::timeout, [this]() { upload_levels_of_detail(); });
+
+	//////////////////////// STAGED UPLOADS //////////////////////////
+
+	m_upload_timer.setInterval(15);
+	connect(&m_upload_timer, &QTimer::timeout, [this]() { upload_staged_meshes(); });
+
+	m_camera_timer.setSingleShot(true);
+	connect(&m_camera_timer, &QTimer::timeout, [this]() {
+		m_camera_moving = false;
+		update();
+	});
+
 	// std::cerr << "viewer context valid? : " << this->context().isValid() <<
 	// '\n';
 	std::cerr << "viewer context adress : " << this->context() << '\n';
 }
 
-void MeshViewer::add(const Mesh_data& md)
+void MeshViewer::add(const Mesh_data& md, const QImage& texture_image)
 {
 	if(!md.positions.has_value())
 	{
@@ -282,50 +317,334 @@ void MeshViewer::add(const Mesh_data& md)
 
 	// Re-calcul de la boite enblobante de visualisation
 
-	for(unsigned int i = 0; i < md.positions->size(); i++)
+	Mesh_data::vec_3f mesh_min = {std::numeric_limits<float>::max(),
+								  std::numeric_limits<float>::max(),
+								  std::numeric_limits<float>::max()};
+	Mesh_data::vec_3f mesh_max = {std::numeric_limits<float>::lowest(),
+								  std::numeric_limits<float>::lowest(),
+								  std::numeric_limits<float>::lowest()};
+
+	for(const auto& position : *md.positions)
+	{
+		for(size_t c = 0; c < 3; ++c)
+		{
+			mesh_min[c] = std::min(mesh_min[c], position[c]);
+			mesh_max[c] = std::max(mesh_max[c], position[c]);
+		}
+	}
+
+	extend_scene(mesh_min, mesh_max);
+
+	// Allocation des données sur le gpu
+
+	select_shader_program(md.texture_path.has_value());
+
+	meshes.emplace_back();
+	allocate_mesh(meshes.back(), md, texture_image);
+
+	meshes.back().set_bounding_box(mesh_min, mesh_max);
+	meshes[meshes.size() - 1].use(*used_shader_program);
+
+	if(m_levels_of_detail)
+		build_levels_of_detail([md]() { return to_surface_mesh(md); });
+	// meshes[meshes.size() - 1].use(*shader_program_texture_only);
+}
+
+void MeshViewer::add(const Mapped_mesh& mesh, const QImage& texture_image)
+{
+	if(mesh.positions.empty())
+	{
+		std::cerr
+			<< "[WARNING] cannot view mesh data without positions defined\n";
+		return;
+	}
+
+	auto [mesh_min, mesh_max] = bounding_box(mesh);
+
+	extend_scene(mesh_min, mesh_max);
+
+	select_shader_program(mesh.texture_path.has_value());
+
+	meshes.emplace_back();
+
+	// Le format compact est écrit à partir des tableaux de Mesh_data
+	if(m_packed_vertices)
+		meshes.back().allocate_packed(to_mesh_data(mesh), texture_image);
+	else
+		meshes.back().allocate(mesh, texture_image);
+
+	meshes.back().set_bounding_box(mesh_min, mesh_max);
+	meshes.back().use(*used_shader_program);
+
+	// La projection du fichier n'appartient pas au viewer : les sommets sont copiés avant de
+	// lancer la simplification
+	if(m_levels_of_detail)
+		build_levels_of_detail([data = to_mesh_data(mesh)]() { return to_surface_mesh(data); });
+}
+
+void MeshViewer::add(const Surface_mesh& mesh, const QImage& texture_image)
+{
+	if(mesh.number_of_vertices() == 0)
+	{
+		std::cerr
+			<< "[WARNING] cannot view mesh data without positions defined\n";
+		return;
+	}
+
+	Mesh_data::vec_3f mesh_min = {std::numeric_limits<float>::max(),
+								  std::numeric_limits<float>::max(),
+								  std::numeric_limits<float>::max()};
+	Mesh_data::vec_3f mesh_max = {std::numeric_limits<float>::lowest(),
+								  std::numeric_limits<float>::lowest(),
+								  std::numeric_limits<float>::lowest()};
+
+	for(auto v : mesh.vertices())
+	{
+		const auto& point = mesh.point(v);
+
+		for(int c = 0; c < 3; ++c)
+		{
+			mesh_min[c] = std::min(mesh_min[c], static_cast<float>(point[c]));
+			mesh_max[c] = std::max(mesh_max[c], static_cast<float>(point[c]));
+		}
+	}
+
+	extend_scene(mesh_min, mesh_max);
+
+	select_shader_program(!texture_image.isNull());
+
+	meshes.emplace_back();
+	meshes.back().allocate(mesh, texture_image);
+	meshes.back().set_bounding_box(mesh_min, mesh_max);
+	meshes.back().use(*used_shader_program);
+
+	// Le maillage n'appartient pas au viewer : il est copié une fois dans la tâche, qui le rend
+	// ensuite sans nouvelle copie (make_mesh n'est appelé qu'une fois)
+	if(m_levels_of_detail)
+		build_levels_of_detail([mesh]() mutable { return std::move(mesh); });
+}
+
+void MeshViewer::set_packed_vertices(bool packed_vertices)
+{
+	m_packed_vertices = packed_vertices;
+}
+
+void MeshViewer::set_levels_of_detail(bool levels_of_detail)
+{
+	m_levels_of_detail = levels_of_detail;
+}
+
+void MeshViewer::set_upload_budget(size_t bytes_per_frame)
+{
+	m_upload_budget = bytes_per_frame;
+}
+
+void MeshViewer::allocate_mesh(QGLMesh& mesh, const Mesh_data& data, const QImage& texture_image)
+{
+	if(m_upload_budget > 0)
 	{
-		Mesh_data::vec_3f position((*md.positions)[i]);
-		// std::CGAL::qglviewer::Vec position(static_cast<qreal>((*md.positions)[i][0]), static_cast<qreal>((*md.positions)[i][1]),
-								//   static_cast<qreal>((*md.positions)[i][2]));
+		mesh.allocate_staged(data, texture_image, m_packed_vertices);
 
-		
-		bb_min = bb_min < position ? bb_min : position;
-		bb_max = bb_max > position ? bb_max : position;
+		if(!mesh.is_uploaded())
+			m_upload_timer.start();
+	}
+	else if(m_packed_vertices)
+	{
+		mesh.allocate_packed(data, texture_image);
+	}
+	else
+	{
+		mesh.allocate(data, texture_image);
 	}
+}
+
+void MeshViewer::upload_staged_meshes()
+{
+	size_t budget	  = m_upload_budget;
+	bool all_uploaded = true;
+
+	makeCurrent();
+
+	auto upload = [&](QGLMesh& mesh) {
+		if(mesh.is_uploaded())
+			return;
 
-	CGAL::qglviewer::Vec min(static_cast<qreal>(bb_min[0]),
-							 static_cast<qreal>(bb_min[1]),
-							 static_cast<qreal>(bb_min[2]));
-	CGAL::qglviewer::Vec max(static_cast<qreal>(bb_max[0]),
-							 static_cast<qreal>(bb_max[1]),
-							 static_cast<qreal>(bb_max[2]));
+		if(budget > 0)
+			budget -= std::min(budget, mesh.upload(*this, budget));
+
+		all_uploaded = all_uploaded && mesh.is_uploaded();
+	};
+
+	// Les maillages d'origine passent avant leurs niveaux de détail
+	for(auto& mesh : meshes)
+		upload(mesh);
+
+	for(auto& levels : m_levels)
+	{
+		for(auto& level : levels)
+			upload(level);
+	}
+
+	doneCurrent();
+
+	if(all_uploaded)
+		m_upload_timer.stop();
+
+	update();
+}
+
+void MeshViewer::build_levels_of_detail(std::function<Surface_mesh()> make_mesh)
+{
+	m_pending_levels.push_back(
+		{meshes.size() - 1, std::async(std::launch::async, [make_mesh = std::move(make_mesh)]() {
+			 return make_levels_of_detail(make_mesh());
+		 })});
+
+	m_levels_timer.start();
+}
+
+void MeshViewer::upload_levels_of_detail()
+{
+	makeCurrent();
+
+	for(auto pending = m_pending_levels.begin(); pending != m_pending_levels.end();)
+	{
+		if(pending->levels.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			++pending;
+			continue;
+		}
+
+		size_t i = pending->mesh_index;
+		std::vector<Mesh_data> levels;
+
+		// Une exception de la simplification (ex: maillage non manifold) ne doit pas sortir de la
+		// boucle d'évènements : le maillage reste affiché en pleine résolution
+		try
+		{
+			levels = pending->levels.get();
+		}
+		catch(const std::exception& exception)
+		{
+			std::cerr << "[ERROR] mesh " << i << " : levels of detail not built (" << exception.what()
+					  << ")\n";
+
+			pending = m_pending_levels.erase(pending);
+			continue;
+		}
+
+		if(m_levels.size() < meshes.size())
+			m_levels.resize(meshes.size());
+
+		auto [mesh_min, mesh_max] = meshes[i].bounding_box();
+
+		// Les niveaux n'ont pas de texture : celle du maillage d'origine est liée avant leur
+		// affichage (cf. draw)
+		for(const auto& level : levels)
+		{
+			m_levels[i].emplace_back();
+			allocate_mesh(m_levels[i].back(), level, QImage());
+
+			m_levels[i].back().set_bounding_box(mesh_min, mesh_max);
+			m_levels[i].back().use(*used_shader_program);
+		}
+
+		std::clog << "[STATUS] mesh " << i << " : " << levels.size()
+				  << " level(s) of detail uploaded\n";
+
+		pending = m_pending_levels.erase(pending);
+	}
+
+	doneCurrent();
+
+	if(m_pending_levels.empty())
+		m_levels_timer.stop();
+
+	update();
+}
+
+size_t MeshViewer::select_level_of_detail(size_t mesh_index) const
+{
+	if(mesh_index >= m_levels.size() || m_levels[mesh_index].empty())
+		return 0;
+
+	auto [mesh_min, mesh_max] = meshes[mesh_index].bounding_box();
+
+	CGAL::qglviewer::Vec min(mesh_min[0], mesh_min[1], mesh_min[2]);
+	CGAL::qglviewer::Vec max(mesh_max[0], mesh_max[1], mesh_max[2]);
+
+	// Taille du maillage à l'écran en pixels
+	qreal pixel_size = camera()->pixelGLRatio((min + max) / 2.0);
+
+	if(pixel_size <= 0.0)
+		return 0;
+
+	double screen_size		= (max - min).norm() / pixel_size;
+	double wanted_triangles = lod_triangles_per_pixel * screen_size * screen_size;
+	const auto& mesh_levels = m_levels[mesh_index];
+
+	// Niveau le plus grossier qui a encore assez de triangles
+	size_t level = 0;
+
+	while(level < mesh_levels.size() && mesh_levels[level].number_of_faces() >= wanted_triangles)
+		++level;
+
+	// Pendant un mouvement de la caméra, un niveau plus grossier est affiché
+	if(m_camera_moving)
+		level = std::min(level + 1, mesh_levels.size());
+
+	return level;
+}
+
+void MeshViewer::update_camera_motion(const GLfloat* MVP_matrix)
+{
+	if(std::equal(m_last_MVP_matrix.begin(), m_last_MVP_matrix.end(), MVP_matrix))
+		return;
+
+	std::copy(MVP_matrix, MVP_matrix + 16, m_last_MVP_matrix.begin());
+
+	m_camera_moving = true;
+	m_camera_timer.start(camera_motion_delay);
+}
+
+void MeshViewer::extend_scene(const Mesh_data::vec_3f& mesh_min, const Mesh_data::vec_3f& mesh_max)
+{
+	for(size_t c = 0; c < 3; ++c)
+	{
+		bb_min[c] = std::min(bb_min[c], mesh_min[c]);
+		bb_max[c] = std::max(bb_max[c], mesh_max[c]);
+	}
+
+	fit_scene(bb_min, bb_max);
+}
+
+void MeshViewer::fit_scene(const Mesh_data::vec_3f& min_position,
+						   const Mesh_data::vec_3f& max_position)
+{
+	CGAL::qglviewer::Vec min(static_cast<qreal>(min_position[0]),
+							 static_cast<qreal>(min_position[1]),
+							 static_cast<qreal>(min_position[2]));
+	CGAL::qglviewer::Vec max(static_cast<qreal>(max_position[0]),
+							 static_cast<qreal>(max_position[1]),
+							 static_cast<qreal>(max_position[2]));
 
 	camera()->lookAt((min + max) / 2.0);
 
 	setSceneBoundingBox(min, max);
+}
 
-	// Allocation des données sur le gpu
-
-	if(md.positions.has_value() && md.texture_path.has_value())
+void MeshViewer::select_shader_program(bool has_texture)
+{
+	if(has_texture)
 	{
 		std::cerr << "[DEBUG] Using color and texture shader\n";
 		used_shader_program = shader_program_color_and_texture.get();
 	}
-	else if(md.texture_path.has_value())
-	{
-		std::cerr << "[DEBUG] Using texture only shader\n";
-		used_shader_program = shader_program_texture_only.get();
-	}
 	else
 	{
 		std::cerr << "[DEBUG] Using color only shader\n";
 		used_shader_program = shader_program_color_only.get();
 	}
-
-	meshes.emplace_back(md);
-
-	meshes[meshes.size() - 1].use(*used_shader_program);
-	// meshes[meshes.size() - 1].use(*shader_program_texture_only);
 }
 
 void MeshViewer::draw()
@@ -336,6 +655,7 @@ void MeshViewer::draw()
 
 		GLfloat MVP_matrix_raw[16];
 		this->camera()->getModelViewProjectionMatrix(MVP_matrix_raw);
+		update_camera_motion(MVP_matrix_raw);
 		QMatrix4x4 MVP_matrix;
 
 		for(unsigned int i = 0; i < 16; i++)
@@ -369,6 +689,12 @@ void MeshViewer::draw()
 		used_shader_program->setUniformValue("camera_direction",
 											 camera_direction);
 
+		// Les maillages et leurs morceaux hors de la pyramide de vue ne sont pas dessinés
+		Frustum frustum				   = make_frustum(MVP_matrix_raw);
+		const Frustum* culling_frustum = m_frustum_culling ? &frustum : nullptr;
+
+		m_statistics = Culling_statistics();
+
 		if(m_draw_triangles)
 		{
 			if(m_draw_edges)
@@ -378,7 +704,19 @@ void MeshViewer::draw()
 			{
 				if(m_draw_mesh[i])
 				{
-					meshes[i].draw(*this, *used_shader_program, GL_TRIANGLES);
+					size_t level = select_level_of_detail(i);
+
+					if(level == 0)
+					{
+						m_statistics += meshes[i].draw(*this, *used_shader_program, GL_TRIANGLES,
+													   culling_frustum);
+					}
+					else
+					{
+						meshes[i].bind_texture(*used_shader_program);
+						m_statistics += m_levels[i][level - 1].draw(
+							*this, *used_shader_program, GL_TRIANGLES, culling_frustum);
+					}
 				}
 			}
 
@@ -392,13 +730,38 @@ void MeshViewer::draw()
 			{
 				if(m_draw_mesh[i])
 				{
-					meshes[i].draw(*this, *used_shader_program, GL_POINTS);
+					meshes[i].draw(*this, *used_shader_program, GL_POINTS, culling_frustum);
 				}
 			}
 		}
+
+		if(m_draw_statistics)
+		{
+			used_shader_program->release();
+			draw_statistics();
+		}
 	}
 }
 
+void MeshViewer::draw_statistics()
+{
+	size_t total = m_statistics.drawn_triangles + m_statistics.culled_triangles;
+
+	QString triangles = QString("triangles: %1 drawn, %2 culled (%3%)")
+							.arg(m_statistics.drawn_triangles)
+							.arg(m_statistics.culled_triangles)
+							.arg(total > 0 ? 100.0 * m_statistics.culled_triangles / total : 0.0,
+								 0, 'f', 1);
+
+	QString chunks = QString("chunks: %1 drawn, %2 culled, frustum culling %3")
+						 .arg(m_statistics.drawn_chunks)
+						 .arg(m_statistics.culled_chunks)
+						 .arg(m_frustum_culling ? "on" : "off");
+
+	drawText(10, 20, triangles);
+	drawText(10, 40, chunks);
+}
+
 QString MeshViewer::helpString() const
 {
 	QString text("<h2>S e l e c t</h2>");
@@ -529,6 +892,20 @@ void MeshViewer::keyPressEvent(QKeyEvent* e)
 			QString("draw points = %1.").arg(m_draw_points ? "true" : "false"));
 		update();
 	}
+	else if((e->key() == ::Qt::Key_U) && (modifiers == ::Qt::NoButton))
+	{
+		m_frustum_culling = !m_frustum_culling;
+		displayMessage(QString("frustum culling = %1.")
+						   .arg(m_frustum_culling ? "true" : "false"));
+		update();
+	}
+	else if((e->key() == ::Qt::Key_I) && (modifiers == ::Qt::NoButton))
+	{
+		m_draw_statistics = !m_draw_statistics;
+		displayMessage(QString("draw statistics = %1.")
+						   .arg(m_draw_statistics ? "true" : "false"));
+		update();
+	}
 	else
 	{
 		CGAL::QGLViewer::keyPressEvent(e);
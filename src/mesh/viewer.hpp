@@ -1,11 +1,16 @@
 #ifndef MESH_VIEWER_HPP
 #define MESH_VIEWER_HPP
 
+#include "culling.hpp"
 #include "qglmesh.hpp"
 
 #include <CGAL/Qt/qglviewer.h>
 
+#include <QTimer>
+
 #include <array>
+#include <functional>
+#include <future>
 #include <memory>
 
 class MeshViewer : public CGAL::QGLViewer
@@ -14,7 +19,28 @@ class MeshViewer : public CGAL::QGLViewer
 	std::vector<QGLMesh> meshes;
 
 	// MeshViewer();
-	virtual void add(const Mesh_data& data);
+	// 'texture_image' est une texture déjà décodée (cf. read_texture_image), si elle est nulle la
+	// texture est lue depuis 'texture_path'. Le contexte OpenGL du viewer doit être courant.
+	virtual void add(const Mesh_data& data, const QImage& texture_image = QImage());
+
+	// Ajoute un maillage projeté en mémoire (cf. map_ply) sans passer par Mesh_data
+	virtual void add(const Mapped_mesh& mesh, const QImage& texture_image = QImage());
+
+	// Ajoute une Surface_mesh sans passer par Mesh_data (cf. QGLMesh::allocate)
+	virtual void add(const Surface_mesh& mesh, const QImage& texture_image = QImage());
+
+	// Les Mesh_data ajoutés ensuite sont envoyés au GPU au format compact (cf. QGLMesh::allocate_packed)
+	void set_packed_vertices(bool packed_vertices);
+
+	// Les maillages ajoutés ensuite sont simplifiés en tâche de fond (cf. make_levels_of_detail) :
+	// à chaque image, le niveau affiché dépend de la taille du maillage à l'écran, et un niveau
+	// plus grossier est utilisé pendant les mouvements de la caméra.
+	void set_levels_of_detail(bool levels_of_detail);
+
+	// Si 'bytes_per_frame' n'est pas nul, les Mesh_data ajoutés ensuite (et leurs niveaux de
+	// détail) sont envoyés au GPU par morceaux, au plus 'bytes_per_frame' octets par image
+	// (cf. QGLMesh::allocate_staged) : ils apparaissent progressivement sans bloquer l'interface.
+	void set_upload_budget(size_t bytes_per_frame);
 
   protected:
 	virtual void draw();
@@ -25,6 +51,33 @@ class MeshViewer : public CGAL::QGLViewer
 	void load_texture(const std::string& filename);
 	bool GLLogErrors();
 
+	// Étend la boite englobante de la scène à celle d'un maillage ajouté et recentre la caméra
+	void extend_scene(const Mesh_data::vec_3f& mesh_min, const Mesh_data::vec_3f& mesh_max);
+	void fit_scene(const Mesh_data::vec_3f& min, const Mesh_data::vec_3f& max);
+
+	// Affiche le nombre de triangles dessinés et éliminés lors du dernier affichage
+	void draw_statistics();
+
+	// Lance la construction des niveaux de détail du dernier maillage ajouté dans un thread,
+	// 'make_mesh' est appelé dans ce thread
+	void build_levels_of_detail(std::function<Surface_mesh()> make_mesh);
+
+	// Envoie au GPU les niveaux de détail dont la construction est terminée
+	void upload_levels_of_detail();
+
+	// Alloue un maillage de façon directe ou étalée selon m_upload_budget
+	void allocate_mesh(QGLMesh& mesh, const Mesh_data& data, const QImage& texture_image);
+
+	// Envoie la part de l'image suivante des maillages en cours d'envoi
+	void upload_staged_meshes();
+
+	// 0 pour le maillage d'origine, k pour m_levels[mesh_index][k - 1]
+	size_t select_level_of_detail(size_t mesh_index) const;
+
+	// Détecte les mouvements de la caméra à partir de la matrice de projection de l'image
+	void update_camera_motion(const GLfloat* MVP_matrix);
+	void select_shader_program(bool has_texture);
+
 	QOpenGLShaderProgram* used_shader_program = nullptr;
 
 	std::unique_ptr<QOpenGLShaderProgram> shader_program_color_only;
@@ -38,6 +91,32 @@ class MeshViewer : public CGAL::QGLViewer
 	bool m_draw_edges	  = false;
 	bool m_draw_points	  = false;
 
+	bool m_packed_vertices = false;
+
+	bool m_frustum_culling = true;
+	bool m_draw_statistics = false;
+
+	Culling_statistics m_statistics; // statistiques du dernier appel à draw
+
+	struct Pending_levels
+	{
+		size_t mesh_index;
+		std::future<std::vector<Mesh_data>> levels;
+	};
+
+	bool m_levels_of_detail = false;
+
+	std::vector<std::vector<QGLMesh>> m_levels; // m_levels[i][k] : niveau k + 1 de meshes[i]
+	std::vector<Pending_levels> m_pending_levels;
+	QTimer m_levels_timer;
+
+	size_t m_upload_budget = 0;
+	QTimer m_upload_timer;
+
+	bool m_camera_moving = false;
+	std::array<GLfloat, 16> m_last_MVP_matrix{};
+	QTimer m_camera_timer; // fin du mouvement de la caméra
+
 	CGAL::qglviewer::Vec orig, dir, selectedPoint;
 };
 
@@ -27,13 +27,8 @@ int main(int argc, char const* argv[])
 
 	std::clog << "[STATUS] reading data from " << filename << "...\n";
 
-	//  Importing scene data from file
-	auto scene = import_scene(filename);
-	print_scene_status(scene.get());
-
-	//  Importing mesh data from scene
-	auto mesh_data_index = find_mesh_index(scene.get());
-	auto mesh			 = make_surface_mesh(scene->mMeshes[mesh_data_index]);
+	//  Importing mesh data from file
+	auto [mesh, texture_path] = import_surface_mesh(filename);
 
 	CGAL::Polygon_mesh_processing::stitch_borders(mesh);
 
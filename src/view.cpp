@@ -1,23 +1,30 @@
 // STD
 #include <iostream>
 #include <random>
+#include <stdexcept>
 
 // PROJECT
 #include "docopt/docopt.h"
-#include "mesh/conversion.hpp"
-#include "mesh/import.hpp"
+#include "mesh/loader.hpp"
 #include "mesh/utils.hpp"
 #include "mesh/viewer.hpp"
 
+// QT5
+#include <QTimer>
+
 static const char USAGE[] =
     R"(3D viewer for geometrical file formats (OFF, PLY, OBJ, ...).
 
     Usage: view [options] <input-files>...
 
     Options:
-      -c, --colorize  Colorize geometrical objects by files.
-      -h, --help      Show this screen.
-      --version      Show version.
+      -c, --colorize                   Colorize geometrical objects by files.
+      -p, --packed                     Upload vertices in a compact interleaved format (24 bytes per vertex).
+      -o, --optimize                   Reorder triangles and vertices for the GPU vertex cache.
+      -l, --lod                        Build simplified levels of detail in background for faster interaction.
+      -u <MiB>, --upload-budget <MiB>  Data sent to the GPU per frame, 0 sends whole meshes at once [default: 8].
+      -h, --help                       Show this screen.
+      --version                        Show version.
 )";
 
 int main(int argc, char** argv)
@@ -30,6 +37,26 @@ int main(int argc, char** argv)
     auto input_files = args.at("<input-files>").asStringList();
 
     auto colorize = args.at("--colorize").asBool();
+    auto packed   = args.at("--packed").asBool();
+    auto optimize = args.at("--optimize").asBool();
+    auto lod      = args.at("--lod").asBool();
+
+    size_t upload_budget = 0;
+
+    try
+    {
+        int budget = std::stoi(args.at("--upload-budget").asString());
+
+        if(budget < 0)
+            throw std::invalid_argument("negative upload budget");
+
+        upload_budget = static_cast<size_t>(budget) << 20;
+    }
+    catch(std::invalid_argument& ia)
+    {
+        std::cerr << "[ERROR] --upload-budget=<MiB> must be a positive integer\n";
+        exit(EXIT_FAILURE);
+    }
 
     // VISUALISATION
 
@@ -46,32 +73,20 @@ int main(int argc, char** argv)
 
     MeshViewer viewer;
     viewer.setWindowTitle("surgery-viewer");
+    viewer.set_packed_vertices(packed);
+    viewer.set_levels_of_detail(lod);
+    viewer.set_upload_budget(upload_budget);
     viewer.show(); // Create Opengl context
 
     std::cerr << "[DEBUG] Loading meshes...\n";
 
-    for(size_t i = 0; i < input_files.size(); ++i)
-    {
-        //  Importing scene data from file
-        auto scene = import_scene(input_files[i]);
-        print_scene_status(scene.get());
-
-        //  Finding mesh data from scene
-        auto mesh_data_index = find_mesh_index(scene.get());
-        auto mesh_data       = scene->mMeshes[mesh_data_index];
-
-        //  Finding texture data from mesh
-        auto mesh_material = scene->mMaterials[mesh_data->mMaterialIndex];
-        auto mesh_texture_path =
-            find_texture_path(input_files[i], mesh_material);
-
-        std::cerr << "texture_path_found" << mesh_texture_path << '\n';
-
-        // Creating surface mesh
-        auto surface_mesh = make_surface_mesh(mesh_data);
+    // La coloration a besoin d'une surface mesh, elle est appliquée par les
+    // threads de chargement
+    Mesh_loader::Surface_mesh_function colorize_mesh;
 
-        if(colorize)
-        {
+    if(colorize)
+    {
+        colorize_mesh = [](size_t i, Surface_mesh& surface_mesh) {
             if(i == 0)
             {
                 set_mesh_color(surface_mesh, {1.0f, 0.0f, 0.0f, 1.0f});
@@ -88,12 +103,39 @@ int main(int argc, char** argv)
             {
                 set_mesh_color(surface_mesh, random_color());
             }
+        };
+    }
+
+    // Les fichiers sont lus en parallèle, chaque maillage est envoyé au GPU
+    // depuis le thread graphique dès qu'il est prêt (dans l'ordre des fichiers)
+    Mesh_loader loader(input_files, colorize_mesh, optimize);
+
+    QTimer upload_timer;
+
+    QObject::connect(&upload_timer, &QTimer::timeout, [&]() {
+        if(auto loaded_mesh = loader.try_pop())
+        {
+            viewer.makeCurrent();
+
+            if(loaded_mesh->mapped)
+                viewer.add(*loaded_mesh->mapped, loaded_mesh->texture);
+            else if(loaded_mesh->surface_mesh)
+                viewer.add(*loaded_mesh->surface_mesh, loaded_mesh->texture);
+            else
+                viewer.add(*loaded_mesh->data, loaded_mesh->texture);
+
+            viewer.doneCurrent();
+            viewer.update();
         }
 
-        viewer.add(to_mesh_data(surface_mesh, mesh_texture_path));
-    }
+        if(loader.finished())
+        {
+            upload_timer.stop();
+            std::cerr << "[DEBUG] Mesh(es) loaded successfuly !\n";
+        }
+    });
 
-    std::cerr << "[DEBUG] Mesh(es) loaded successfuly !\n";
+    upload_timer.start(10);
 
     return application.exec();
 }
\ No newline at end of file